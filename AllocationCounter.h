@@ -0,0 +1,14 @@
+#ifndef REFACTORED_THESIS_ALLOCATIONCOUNTER_H
+#define REFACTORED_THESIS_ALLOCATIONCOUNTER_H
+
+#include <cstddef>
+
+/**
+ * The number of heap allocations (operator new, in all its forms) made by the calling thread so far. The global
+ * operator new is replaced to count them, e.g. to verify that solving graphs in a solve_arena does not allocate:
+ * compare the count before and after.
+ */
+std::size_t thread_allocation_count();
+
+
+#endif //REFACTORED_THESIS_ALLOCATIONCOUNTER_H
@@ -0,0 +1,139 @@
+#include "BatchSolver.h"
+#include <algorithm>
+#include <stdexcept>
+#include "SolveStats.h"
+
+/**
+ * Prepares the subset tables of the order, which is the expensive part of creating a solver.
+ * @param table EnumerationAlgorithm::set_size_table (as readFile, orders 5 to 12) or all_sizes_table (as
+ *        readChordalFile)
+ */
+BatchSolver::BatchSolver(unsigned int order, double toughness_test, unsigned char table)
+        : order(order), toughness_test(toughness_test) {
+    if (not find_kernels(order)) {
+        throw std::invalid_argument("The batch solver only supports orders with kernels");
+    }
+    subsets = EnumerationAlgorithm::get_subset_table(order, table);
+    subset_masks = EnumerationAlgorithm::get_set_masks(subsets);
+    arena.graph.set_toughness_test(toughness_test);
+}
+
+/**
+ * Solves the graph loaded in the arena and writes its pair_count() results.
+ */
+void BatchSolver::solve_loaded(pair_result *results) {
+    std::fill(results, results + pair_count(), pair_result{});
+    if (arena.graph.hasCompleteClosure(order + 1)) {
+        TNH_COUNT(event_closure_rejected);
+        for (std::size_t pair_index = 0; pair_index < pair_count(); pair_index++) {
+            results[pair_index].kind = pair_closure;
+        }
+        return;
+    }
+    arena.graph.solve(subsets, subset_masks, arena.previous, arena.witnesses);
+    const witness_table &witnesses = arena.witnesses;
+    std::size_t pair_index = 0;
+    for (std::size_t pair1 = 0; pair1 + 1 < order; pair1++) {
+        for (std::size_t pair2 = pair1 + 1; pair2 < order; pair2++, pair_index++) {
+            pair_result &result = results[pair_index];
+            if (witnesses.kinds[pair_index] == path_witness) {
+                result.kind = pair_path;
+                std::copy(witnesses.paths[pair_index].begin(), witnesses.paths[pair_index].end(), result.path);
+            } else if (witnesses.kinds[pair_index] == cut_witness) {
+                result.kind = pair_cut;
+                result.alive = to_mask(witnesses.cuts[pair_index]);
+                result.components = arena.graph.cut_components(pair1, pair2, witnesses.cuts[pair_index]);
+            } else {
+                result.kind = pair_counterexample;
+            }
+        }
+    }
+    arena.next_graph();
+}
+
+/**
+ * Solves a graph given as graph6 string (without header, not necessarily null terminated).
+ * @param results receives the pair_count() results of the graph
+ */
+void BatchSolver::solve(const char *graph6, std::size_t length, pair_result *results) {
+    std::size_t bit_count = order * (order - 1) / 2;
+    if (length != 1 + (bit_count + 5) / 6 or (unsigned char) graph6[0] != order + 63) {
+        throw std::invalid_argument("The graph6 string " + std::string(graph6, length) + " is not of order "
+                                    + std::to_string(order));
+    }
+    if (std::any_of(graph6 + 1, graph6 + length, [](char c) { return c < 63 or c > 126; })) {
+        throw std::invalid_argument("The graph6 string " + std::string(graph6, length) + " is malformed");
+    }
+    arena.graph.load(graph6, length);
+    solve_loaded(results);
+}
+
+/**
+ * Solves a graph given as adjacency table of order rows, as GraphGenerator produces them. The table must describe a
+ * simple undirected graph: no bits at or above the order, no loops and symmetric rows.
+ * @param results receives the pair_count() results of the graph
+ */
+void BatchSolver::solve(const mask_t *adjacency, pair_result *results) {
+    mask_t vertices = kernels::full_mask(order);
+    for (unsigned int v = 0; v < order; v++) {
+        if (adjacency[v] & ~vertices or adjacency[v] >> v & 1) {
+            throw std::invalid_argument("Row " + std::to_string(v) + " of the adjacency table has a vertex beyond "
+                                        "the order or a loop");
+        }
+        for (mask_t row = adjacency[v]; row; row &= row - 1) {
+            if (not (adjacency[kernels::lowest(row)] >> v & 1)) {
+                throw std::invalid_argument("The adjacency table is not symmetric in row " + std::to_string(v));
+            }
+        }
+    }
+    arena.graph.load(adjacency, order);
+    arena.graph.load(adjacency, order);
+    solve_loaded(results);
+}
+
+/**
+ * Solves the graphs in buffer, which holds one graph6 string per line as a geng file without header. Empty lines are
+ * skipped, and at most max_graphs graphs are solved.
+ * @param results receives pair_count() results per graph, in the order of the graphs
+ * @return the number of graphs solved
+ */
+std::size_t BatchSolver::solve_lines(const char *buffer, std::size_t size, pair_result *results,
+                                     std::size_t max_graphs) {
+    std::size_t graphs = 0;
+    const char *end = buffer + size;
+    for (const char *line = buffer; line < end and graphs < max_graphs;) {
+        const char *line_end = std::find(line, end, '\n');
+        std::size_t length = line_end - line;
+        if (length > 0 and line[length - 1] == '\r') {
+            length--;
+        }
+        if (length > 0) {
+            solve(line, length, results + graphs * pair_count());
+            graphs++;
+        }
+        line = line_end + 1;
+    }
+    return graphs;
+}
+
+/**
+ * Solves count graphs given as consecutive adjacency tables of order rows each.
+ * @param results receives pair_count() results per graph, in the order of the graphs
+ */
+void BatchSolver::solve_tables(const mask_t *adjacency, std::size_t count, pair_result *results) {
+    for (std::size_t graph = 0; graph < count; graph++) {
+        solve(adjacency + graph * order, results + graph * pair_count());
+    }
+}
+
+/**
+ * Solves the graph6 strings in graphs.
+ * @return pair_count() results per graph, in the order of the graphs
+ */
+std::vector<pair_result> BatchSolver::solve(const std::vector<std::string> &graphs) {
+    std::vector<pair_result> results(graphs.size() * pair_count());
+    for (std::size_t graph = 0; graph < graphs.size(); graph++) {
+        solve(graphs[graph].data(), graphs[graph].size(), results.data() + graph * pair_count());
+    }
+    return results;
+}
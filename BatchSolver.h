@@ -0,0 +1,59 @@
+#ifndef REFACTORED_THESIS_BATCHSOLVER_H
+#define REFACTORED_THESIS_BATCHSOLVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "EnumerationAlgorithm.h"
+#include "EnumerationGraph.h"
+
+enum pair_kind : std::uint8_t {
+    pair_path = 0,            // a Hamilton path between the pair was found
+    pair_cut = 1,             // a cut with (2|S| + 1) / (2 omega') < toughness_test was found
+    pair_counterexample = 2,  // neither, after scanning the complete subset table
+    pair_closure = 3          // the closure of the graph is complete, so the pair is traceable (no path is searched)
+};
+
+/**
+ * The result of one vertex pair, the pairs of a graph are in the order (0,1), (0,2), ..., (1,2), ... of
+ * EnumerationGraph::solve. The layout is fixed (see tnh.h), such that results can be written to memory of the caller.
+ */
+struct pair_result {
+    mask_t alive;                            // pair_cut: the vertices not in the cut
+    std::uint8_t kind;                       // a pair_kind
+    std::uint8_t components;                 // pair_cut: omega', the components containing neither vertex of the pair
+    std::uint8_t path[max_kernel_order];     // pair_path: the Hamilton path, from pair1 to pair2
+    std::uint8_t reserved[2];
+};
+
+/**
+ * Runs the enumeration algorithm on graphs given in memory instead of a file, and returns the results per pair
+ * instead of printing the counterexamples. A solver handles graphs of a single order, which must have kernels (see
+ * find_kernels), and solves them like readFile (set_size_table) or readChordalFile (all_sizes_table).
+ * Every graph has pair_count() results. The results are written to an array of the caller, and a solver reuses its
+ * memory for every graph, so solving does not allocate once the first graphs have been solved. A solver is used by
+ * one thread at a time, threads can each use their own solver.
+ */
+class BatchSolver {
+    unsigned int order;
+    double toughness_test;
+    std::vector<std::pair<int, std::vector<std::vector<bool>>>> subsets;
+    subset_masks_t subset_masks;
+    solve_arena arena;
+
+    void solve_loaded(pair_result *results);
+public:
+    explicit BatchSolver(unsigned int order, double toughness_test=2,
+                         unsigned char table=EnumerationAlgorithm::set_size_table);
+    unsigned int get_order() const { return order; }
+    std::size_t pair_count() const { return order * (order - 1) / 2; }
+    void solve(const char *graph6, std::size_t length, pair_result *results);
+    void solve(const mask_t *adjacency, pair_result *results);
+    std::size_t solve_lines(const char *buffer, std::size_t size, pair_result *results, std::size_t max_graphs);
+    void solve_tables(const mask_t *adjacency, std::size_t count, pair_result *results);
+    std::vector<pair_result> solve(const std::vector<std::string> &graphs);
+};
+
+
+#endif //REFACTORED_THESIS_BATCHSOLVER_H
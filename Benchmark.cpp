@@ -0,0 +1,263 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include "AllocationCounter.h"
+#include "CutBatch.h"
+#include "EnumerationAlgorithm.h"
+#include "EnumerationGraph.h"
+#include "EvolutionGraph.h"
+
+/**
+ * The tnh_bench benchmark suite: micro benchmarks of the graph operations (graph6 decoding, closure, Hamilton path
+ * search, component counting under a cut) and macro benchmarks of the algorithms (EnumerationGraph::solve per graph,
+ * the load-closure-solve loop of readFile in a solve_arena per graph, EvolutionGraph::solve_mutation per offspring)
+ * for the orders 5 to 14. The readFile loop must not allocate, which is reported on stderr otherwise.
+ * The inputs are random connected graphs (edge probability 1/2) drawn from a fixed seed, so every run and every commit
+ * measures the same work. Each benchmark repeats its workload until min_time has passed.
+ *
+ * Usage: tnh_bench [output.json] [min_order] [max_order]
+ * The results are written as JSON (to stdout by default) with per benchmark and order the number of operations,
+ * ns/op, graphs/s and heap allocations per operation.
+ */
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr unsigned int bench_seed = 2021;
+constexpr unsigned int graphs_per_order = 32;
+constexpr double min_time = 0.2;  // seconds per benchmark
+
+struct bench_result {
+    std::string name;
+    unsigned int order;
+    std::size_t ops;      // operations timed (a graph, a cut or an offspring)
+    std::size_t graphs;   // graphs processed by these operations
+    double seconds;
+    std::size_t allocations;
+};
+
+/**
+ * Runs workload (which performs ops operations on graphs graphs, and may exclude its setup from the time by calling
+ * pause / resume on the timer) until min_time has passed.
+ */
+class bench_timer {
+    clock_type::time_point start;
+    double elapsed = 0;
+    std::size_t allocations = 0, allocations_start = 0;
+public:
+    void resume() {
+        allocations_start = thread_allocation_count();
+        start = clock_type::now();
+    }
+    void pause() {
+        elapsed += std::chrono::duration<double>(clock_type::now() - start).count();
+        allocations += thread_allocation_count() - allocations_start;
+    }
+
+    template<class Workload>
+    static bench_result run(const std::string &name, unsigned int order, std::size_t ops, std::size_t graphs,
+                            Workload workload) {
+        bench_timer timer;
+        bench_result result{name, order, 0, 0, 0, 0};
+        while (timer.elapsed < min_time) {
+            workload(timer);
+            result.ops += ops;
+            result.graphs += graphs;
+        }
+        result.seconds = timer.elapsed;
+        result.allocations = timer.allocations;
+        return result;
+    }
+};
+
+/**
+ * @return graphs_per_order random connected graphs of the given order as graph6 strings
+ */
+std::vector<std::string> random_graphs(unsigned int order, std::mt19937 &rng) {
+    std::bernoulli_distribution coin_dist{0.5};
+    const graph_kernels &kernels = *find_kernels(order);
+    std::vector<std::string> graphs;
+    std::vector<mask_t> adjacency(order);
+    while (graphs.size() < graphs_per_order) {
+        std::fill(adjacency.begin(), adjacency.end(), 0);
+        for (unsigned int j = 1; j < order; j++) {
+            for (unsigned int i = 0; i < j; i++) {
+                if (coin_dist(rng)) {
+                    adjacency[i] |= mask_t(1) << j;
+                    adjacency[j] |= mask_t(1) << i;
+                }
+            }
+        }
+        if (kernels.count_components(adjacency.data(), kernels::full_mask(order), 0) == 1) {
+            graphs.push_back(to_graph6(adjacency.data(), order));
+        }
+    }
+    return graphs;
+}
+
+std::vector<bench_result> run_order(unsigned int order) {
+    std::vector<bench_result> results;
+    std::mt19937 rng(bench_seed + order);  // the same graphs whatever orders are run
+    const std::vector<std::string> graphs = random_graphs(order, rng);
+    const double toughness_test = 2;
+    std::vector<std::pair<int, std::vector<std::vector<bool>>>> subsets;
+    for (unsigned int i = 2; i < order; i++) {
+        subsets.emplace_back(i, EnumerationAlgorithm::get_sets(order, i));
+    }
+    subset_masks_t subset_masks = EnumerationAlgorithm::get_set_masks(subsets);
+    std::vector<EnumerationGraph> decoded;
+    for (const auto &graph6 : graphs) {
+        decoded.emplace_back(graph6, toughness_test);
+    }
+
+    results.push_back(bench_timer::run("decode_graph6", order, graphs.size(), graphs.size(), [&](bench_timer &timer) {
+        timer.resume();
+        for (const auto &graph6 : graphs) {
+            EnumerationGraph graph(graph6, toughness_test);
+        }
+        timer.pause();
+    }));
+
+    results.push_back(bench_timer::run("complete_closure", order, graphs.size(), graphs.size(),
+                                       [&](bench_timer &timer) {
+        std::vector<EnumerationGraph> copies = decoded;  // the closure changes the graph
+        timer.resume();
+        for (auto &graph : copies) {
+            graph.hasCompleteClosure(order + 1);
+        }
+        timer.pause();
+    }));
+
+    results.push_back(bench_timer::run("exists_hamilton_path", order, graphs.size(), graphs.size(),
+                                       [&](bench_timer &timer) {
+        timer.resume();
+        for (auto &graph : decoded) {
+            graph.exists_hamilton_path(0, order - 1);
+        }
+        timer.pause();
+    }));
+
+    const std::vector<std::vector<bool>> &cuts = subsets[(order - 2) / 2].second;
+    results.push_back(bench_timer::run("cut_components", order, graphs.size() * cuts.size(), graphs.size(),
+                                       [&](bench_timer &timer) {
+        timer.resume();
+        int total = 0;
+        for (const auto &graph : decoded) {
+            for (const auto &cut : cuts) {
+                total += graph.cut_components(0, order - 1, cut);
+            }
+        }
+        timer.pause();
+        if (total < 0) {
+            std::cerr << total;  // keeps the loop from being optimised away
+        }
+    }));
+
+    results.push_back(bench_timer::run("enumeration_solve", order, graphs.size(), graphs.size(),
+                                       [&](bench_timer &timer) {
+        std::vector<EnumerationGraph> copies = decoded;
+        witness_table previous, witnesses;
+        timer.resume();
+        for (auto &graph : copies) {
+            if (not graph.hasCompleteClosure(order + 1)) {
+                graph.solve(subsets, subset_masks, previous, witnesses);
+                std::swap(previous, witnesses);
+            }
+        }
+        timer.pause();
+    }));
+
+    // the loop of readFile: every graph is loaded into the arena of this thread, which stops allocating once both of
+    // its witness tables have seen the graphs (the warm up, twice as the tables alternate)
+    solve_arena &arena = thread_solve_arena();
+    arena.graph.set_toughness_test(toughness_test);
+    auto pipeline = [&] {
+        for (const auto &graph6 : graphs) {
+            arena.graph.load(graph6);
+            if (not arena.graph.hasCompleteClosure(order + 1)) {
+                arena.graph.solve(subsets, subset_masks, arena.previous, arena.witnesses);
+                arena.next_graph();
+            }
+        }
+    };
+    pipeline();
+    pipeline();
+    results.push_back(bench_timer::run("enumeration_pipeline", order, graphs.size(), graphs.size(),
+                                       [&](bench_timer &timer) {
+        timer.resume();
+        pipeline();
+        timer.pause();
+    }));
+    if (results.back().allocations > 0) {
+        std::cerr << "The enumeration pipeline allocated " << results.back().allocations << " times on order " << order
+                  << std::endl;
+    }
+
+    // offspring of a single parent as in EvolutionaryAlgorithm::nextGen, the parent is not replaced
+    const std::size_t offspring = 64;
+    EvolutionGraph parent;
+    for (unsigned int seed = bench_seed;; seed++) {
+        parent = EvolutionGraph(order, 0.5, seed);
+        if (parent.get_number_of_components() == 1) {
+            break;
+        }
+    }
+    double parent_tough;
+    std::vector<bool> parent_cut;
+    std::tie(parent_tough, parent_cut) = parent.solve_mutation(subsets, subset_masks, 0, parent_cut);
+    std::mt19937 mutation_rng(bench_seed);
+    results.push_back(bench_timer::run("evolution_solve_mutation", order, offspring, offspring,
+                                       [&](bench_timer &timer) {
+        mutation_rng.seed(bench_seed);
+        timer.resume();
+        for (std::size_t i = 0; i < offspring; i++) {
+            mutation_t mutation = parent.mutate(mutation_rng);
+            parent.solve_mutation(subsets, subset_masks, parent_tough, parent_cut, mutation.addition);
+            parent.undo_mutation(mutation);
+        }
+        timer.pause();
+    }));
+    return results;
+}
+
+void write_json(std::ostream &out, const std::vector<bench_result> &results) {
+    out << "{\n  \"suite\": \"tnh_bench\",\n  \"seed\": " << bench_seed << ",\n  \"graphs_per_order\": "
+        << graphs_per_order << ",\n  \"batch_isa\": \"" << cut_batch_isa_name(get_cut_batch_isa()) << "\",\n"
+        << "  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const bench_result &result = results[i];
+        out << "    {\"name\": \"" << result.name << "\", \"order\": " << result.order << ", \"ops\": " << result.ops
+            << ", \"ns_per_op\": " << result.seconds * 1e9 / result.ops
+            << ", \"graphs_per_s\": " << result.graphs / result.seconds
+            << ", \"allocs_per_op\": " << double(result.allocations) / result.ops << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+}
+
+int main(int argc, char **argv) {
+    unsigned int min_order = argc > 2 ? std::stoi(argv[2]) : 5;
+    unsigned int max_order = argc > 3 ? std::stoi(argv[3]) : 14;
+    if (min_order < min_kernel_order or max_order > max_kernel_order or min_order > max_order) {
+        std::cerr << "The orders must lie in [" << min_kernel_order << ", " << max_kernel_order << "]" << std::endl;
+        return 1;
+    }
+    std::vector<bench_result> results;
+    for (unsigned int order = min_order; order <= max_order; order++) {
+        std::cerr << "order " << order << std::endl;
+        auto order_results = run_order(order);
+        results.insert(results.end(), order_results.begin(), order_results.end());
+    }
+    if (argc > 1) {
+        std::ofstream out(argv[1]);
+        write_json(out, results);
+    } else {
+        write_json(std::cout, results);
+    }
+    return 0;
+}
@@ -0,0 +1,285 @@
+#include "CutBatch.h"
+#include <algorithm>
+#include <atomic>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CUT_BATCH_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using batch_function = void (*)(const mask_t *, unsigned int, const mask_t *, std::size_t, unsigned int, unsigned int,
+                                int *, unsigned char *);
+
+/**
+ * Writes the flags of a cut, joined is non-zero when some component contains both pair vertices.
+ */
+inline unsigned char make_flags(mask_t alive, unsigned int pair1, unsigned int pair2, mask_t joined) {
+    return (unsigned char) ((alive >> pair1 & 1 ? pair1_alive : 0) | (alive >> pair2 & 1 ? pair2_alive : 0) |
+                            (joined ? pairs_joined : 0));
+}
+
+void batch_scalar(const mask_t *adjacency, unsigned int order, const mask_t *alive, std::size_t count,
+                  unsigned int pair1, unsigned int pair2, int *components, unsigned char *flags) {
+    const mask_t both = mask_t(1) << pair1 | mask_t(1) << pair2;
+    for (std::size_t c = 0; c < count; c++) {
+        int comp_count = 0;
+        mask_t joined = 0;
+        mask_t rest = alive[c] & kernels::full_mask(order);
+        while (rest) {
+            mask_t component = rest & (~rest + 1);
+            mask_t frontier = component;
+            while (frontier) {
+                unsigned int v = kernels::lowest(frontier);
+                frontier &= frontier - 1;
+                mask_t reached = adjacency[v] & rest & ~component;
+                component |= reached;
+                frontier |= reached;
+            }
+            rest &= ~component;
+            comp_count++;
+            joined |= (component & both) == both;
+        }
+        components[c] = comp_count;
+        flags[c] = make_flags(alive[c], pair1, pair2, joined);
+    }
+}
+
+#ifdef CUT_BATCH_X86
+
+/*
+ * The vector kernels run one cut per 32 bit lane. Every round grows a component from the lowest remaining vertex of
+ * each lane: all vertices in the component OR their neighbourhood into it (a vertex is selected with a compare against
+ * its bit), until no lane changes. Lanes that are already finished have an empty seed and keep their count.
+ */
+
+__attribute__((target("sse2")))
+void batch_sse2(const mask_t *adjacency, unsigned int order, const mask_t *alive, std::size_t count,
+                unsigned int pair1, unsigned int pair2, int *components, unsigned char *flags) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i both = _mm_set1_epi32(int(mask_t(1) << pair1 | mask_t(1) << pair2));
+    for (std::size_t offset = 0; offset < count; offset += 4) {
+        alignas(16) mask_t lanes[4] = {0, 0, 0, 0};
+        std::size_t width = std::min<std::size_t>(4, count - offset);
+        std::copy(alive + offset, alive + offset + width, lanes);
+        __m128i rest = _mm_and_si128(_mm_load_si128((const __m128i *) lanes),
+                                     _mm_set1_epi32(int(kernels::full_mask(order))));
+        __m128i comp_count = zero;
+        __m128i joined = zero;
+        while (_mm_movemask_epi8(_mm_cmpeq_epi32(rest, zero)) != 0xFFFF) {
+            __m128i seed = _mm_and_si128(rest, _mm_sub_epi32(zero, rest));
+            __m128i component = seed;
+            while (true) {
+                __m128i reached = zero;
+                for (unsigned int v = 0; v < order; v++) {
+                    __m128i bit = _mm_set1_epi32(int(mask_t(1) << v));
+                    __m128i select = _mm_cmpeq_epi32(_mm_and_si128(component, bit), bit);
+                    reached = _mm_or_si128(reached, _mm_and_si128(select, _mm_set1_epi32(int(adjacency[v]))));
+                }
+                __m128i grown = _mm_or_si128(component, _mm_and_si128(reached, rest));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(grown, component)) == 0xFFFF) {
+                    break;
+                }
+                component = grown;
+            }
+            comp_count = _mm_add_epi32(comp_count, _mm_andnot_si128(_mm_cmpeq_epi32(seed, zero), one));
+            joined = _mm_or_si128(joined, _mm_cmpeq_epi32(_mm_and_si128(component, both), both));
+            rest = _mm_andnot_si128(component, rest);
+        }
+        alignas(16) int counts[4];
+        alignas(16) mask_t joins[4];
+        _mm_store_si128((__m128i *) counts, comp_count);
+        _mm_store_si128((__m128i *) joins, joined);
+        for (std::size_t c = 0; c < width; c++) {
+            components[offset + c] = counts[c];
+            flags[offset + c] = make_flags(lanes[c], pair1, pair2, joins[c]);
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+void batch_avx2(const mask_t *adjacency, unsigned int order, const mask_t *alive, std::size_t count,
+                unsigned int pair1, unsigned int pair2, int *components, unsigned char *flags) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i both = _mm256_set1_epi32(int(mask_t(1) << pair1 | mask_t(1) << pair2));
+    for (std::size_t offset = 0; offset < count; offset += 8) {
+        alignas(32) mask_t lanes[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        std::size_t width = std::min<std::size_t>(8, count - offset);
+        std::copy(alive + offset, alive + offset + width, lanes);
+        __m256i rest = _mm256_and_si256(_mm256_load_si256((const __m256i *) lanes),
+                                        _mm256_set1_epi32(int(kernels::full_mask(order))));
+        __m256i comp_count = zero;
+        __m256i joined = zero;
+        while (not _mm256_testz_si256(rest, rest)) {
+            __m256i seed = _mm256_and_si256(rest, _mm256_sub_epi32(zero, rest));
+            __m256i component = seed;
+            while (true) {
+                __m256i reached = zero;
+                for (unsigned int v = 0; v < order; v++) {
+                    __m256i bit = _mm256_set1_epi32(int(mask_t(1) << v));
+                    __m256i select = _mm256_cmpeq_epi32(_mm256_and_si256(component, bit), bit);
+                    reached = _mm256_or_si256(reached,
+                                              _mm256_and_si256(select, _mm256_set1_epi32(int(adjacency[v]))));
+                }
+                __m256i grown = _mm256_or_si256(component, _mm256_and_si256(reached, rest));
+                __m256i difference = _mm256_xor_si256(grown, component);
+                if (_mm256_testz_si256(difference, difference)) {
+                    break;
+                }
+                component = grown;
+            }
+            comp_count = _mm256_add_epi32(comp_count, _mm256_andnot_si256(_mm256_cmpeq_epi32(seed, zero), one));
+            joined = _mm256_or_si256(joined, _mm256_cmpeq_epi32(_mm256_and_si256(component, both), both));
+            rest = _mm256_andnot_si256(component, rest);
+        }
+        alignas(32) int counts[8];
+        alignas(32) mask_t joins[8];
+        _mm256_store_si256((__m256i *) counts, comp_count);
+        _mm256_store_si256((__m256i *) joins, joined);
+        for (std::size_t c = 0; c < width; c++) {
+            components[offset + c] = counts[c];
+            flags[offset + c] = make_flags(lanes[c], pair1, pair2, joins[c]);
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+void batch_avx512(const mask_t *adjacency, unsigned int order, const mask_t *alive, std::size_t count,
+                  unsigned int pair1, unsigned int pair2, int *components, unsigned char *flags) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i both = _mm512_set1_epi32(int(mask_t(1) << pair1 | mask_t(1) << pair2));
+    for (std::size_t offset = 0; offset < count; offset += 16) {
+        std::size_t width = std::min<std::size_t>(16, count - offset);
+        __mmask16 used = __mmask16((1u << width) - 1);
+        __m512i rest = _mm512_maskz_loadu_epi32(used, alive + offset);
+        rest = _mm512_and_si512(rest, _mm512_set1_epi32(int(kernels::full_mask(order))));
+        __m512i comp_count = zero;
+        __mmask16 joined = 0;
+        __mmask16 open = _mm512_test_epi32_mask(rest, rest);
+        while (open) {
+            __m512i seed = _mm512_and_si512(rest, _mm512_sub_epi32(zero, rest));
+            __m512i component = seed;
+            while (true) {
+                __m512i reached = zero;
+                for (unsigned int v = 0; v < order; v++) {
+                    __mmask16 select = _mm512_test_epi32_mask(component, _mm512_set1_epi32(int(mask_t(1) << v)));
+                    reached = _mm512_mask_or_epi32(reached, select, reached, _mm512_set1_epi32(int(adjacency[v])));
+                }
+                __m512i grown = _mm512_or_si512(component, _mm512_and_si512(reached, rest));
+                if (not _mm512_cmpneq_epi32_mask(grown, component)) {
+                    break;
+                }
+                component = grown;
+            }
+            comp_count = _mm512_mask_add_epi32(comp_count, open, comp_count, one);
+            joined |= _mm512_mask_cmpeq_epi32_mask(open, _mm512_and_si512(component, both), both);
+            rest = _mm512_xor_si512(rest, component);  // the component is a subset of rest
+            open = _mm512_test_epi32_mask(rest, rest);
+        }
+        alignas(64) int counts[16];
+        _mm512_store_si512(counts, comp_count);
+        for (std::size_t c = 0; c < width; c++) {
+            components[offset + c] = counts[c];
+            flags[offset + c] = make_flags(alive[offset + c], pair1, pair2, joined >> c & 1);
+        }
+    }
+}
+
+#endif
+
+bool isa_supported(cut_batch_isa isa) {
+#ifdef CUT_BATCH_X86
+    switch (isa) {
+        case isa_avx512:
+            return __builtin_cpu_supports("avx512f");
+        case isa_avx2:
+            return __builtin_cpu_supports("avx2");
+        case isa_sse2:
+            return __builtin_cpu_supports("sse2");
+        default:
+            return true;
+    }
+#else
+    return isa == isa_scalar;
+#endif
+}
+
+batch_function batch_for(cut_batch_isa isa) {
+    switch (isa) {
+#ifdef CUT_BATCH_X86
+        case isa_avx512:
+            return &batch_avx512;
+        case isa_avx2:
+            return &batch_avx2;
+        case isa_sse2:
+            return &batch_sse2;
+#endif
+        default:
+            return &batch_scalar;
+    }
+}
+
+void batch_resolve(const mask_t *adjacency, unsigned int order, const mask_t *alive, std::size_t count,
+                   unsigned int pair1, unsigned int pair2, int *components, unsigned char *flags);
+
+// The first call resolves the instruction set, such that the selection does not depend on static initialisation order.
+// Atomic, as the enumeration threads may all make that first call at once.
+std::atomic<cut_batch_isa> selected_isa{isa_scalar};
+std::atomic<batch_function> selected_batch{&batch_resolve};
+
+void batch_resolve(const mask_t *adjacency, unsigned int order, const mask_t *alive, std::size_t count,
+                   unsigned int pair1, unsigned int pair2, int *components, unsigned char *flags) {
+    set_cut_batch_isa(detect_cut_batch_isa());
+    selected_batch.load()(adjacency, order, alive, count, pair1, pair2, components, flags);
+}
+
+}
+
+cut_batch_isa detect_cut_batch_isa() {
+#ifdef CUT_BATCH_X86
+    __builtin_cpu_init();
+#endif
+    for (cut_batch_isa isa : {isa_avx512, isa_avx2, isa_sse2}) {
+        if (isa_supported(isa)) {
+            return isa;
+        }
+    }
+    return isa_scalar;
+}
+
+void set_cut_batch_isa(cut_batch_isa isa) {
+    while (not isa_supported(isa)) {
+        isa = cut_batch_isa(isa - 1);
+    }
+    selected_isa = isa;
+    selected_batch = batch_for(isa);
+}
+
+cut_batch_isa get_cut_batch_isa() {
+    if (selected_batch == &batch_resolve) {
+        set_cut_batch_isa(detect_cut_batch_isa());
+    }
+    return selected_isa;
+}
+
+const char *cut_batch_isa_name(cut_batch_isa isa) {
+    switch (isa) {
+        case isa_avx512:
+            return "avx512";
+        case isa_avx2:
+            return "avx2";
+        case isa_sse2:
+            return "sse2";
+        default:
+            return "scalar";
+    }
+}
+
+void count_components_batch(const mask_t *adjacency, unsigned int order, const mask_t *alive, std::size_t count,
+                            unsigned int pair1, unsigned int pair2, int *components, unsigned char *flags) {
+    selected_batch.load()(adjacency, order, alive, count, pair1, pair2, components, flags);
+}
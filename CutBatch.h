@@ -0,0 +1,43 @@
+#ifndef REFACTORED_THESIS_CUTBATCH_H
+#define REFACTORED_THESIS_CUTBATCH_H
+
+#include <cstddef>
+#include "GraphKernels.h"
+
+// Largest batch a single call to count_components_batch is meant for (the AVX-512 lane count).
+constexpr std::size_t max_cut_batch = 16;
+
+// Bits of the per-cut flags written by count_components_batch
+constexpr unsigned char pair1_alive = 1;   // pair1 is not in the cut
+constexpr unsigned char pair2_alive = 2;   // pair2 is not in the cut
+constexpr unsigned char pairs_joined = 4;  // pair1 and pair2 are in the same component
+
+// Instruction sets the batch kernel can run on, ordered by lane count (4, 8 and 16 cuts per step).
+enum cut_batch_isa { isa_scalar, isa_sse2, isa_avx2, isa_avx512 };
+
+/**
+ * Counts the components of G - S for a batch of cuts of the same graph. Cut i is given by the vertices alive[i] that
+ * remain, like the rows of the subset tables. components[i] receives the number of components of G[alive[i]] and
+ * flags[i] the pair bits above, together these are what the toughness ratio needs (see omega_prime).
+ * Batches are split over the SIMD lanes of the selected instruction set, any count is allowed.
+ */
+void count_components_batch(const mask_t *adjacency, unsigned int order, const mask_t *alive, std::size_t count,
+                            unsigned int pair1, unsigned int pair2, int *components, unsigned char *flags);
+
+/**
+ * @return the number of components not containing pair1 or pair2, from the output of count_components_batch
+ */
+inline int omega_prime(int components, unsigned char flags) {
+    return components - (flags & pair1_alive ? 1 : 0) - (flags & pair2_alive ? 1 : 0) +
+           (flags & pairs_joined ? 1 : 0);
+}
+
+// The best instruction set supported by this CPU, selected by default.
+cut_batch_isa detect_cut_batch_isa();
+// Overrides the instruction set, e.g. to compare against the scalar kernel. Unsupported choices fall back.
+void set_cut_batch_isa(cut_batch_isa isa);
+cut_batch_isa get_cut_batch_isa();
+const char *cut_batch_isa_name(cut_batch_isa isa);
+
+
+#endif //REFACTORED_THESIS_CUTBATCH_H
@@ -0,0 +1,123 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include "CutBatch.h"
+#include "EnumerationAlgorithm.h"
+#include "GrayCodeCuts.h"
+
+/**
+ * Compares the cut orders of the full scan: the subset tables evaluated one cut at a time, the subset tables
+ * evaluated in SIMD batches, and the revolving door order with incremental components.
+ * Each method computes the minimum of (2|S| + 1) / (2 omega') over all cuts of a fixed random graph, without early
+ * exit, for the pair (0, n-1); the tables are built beforehand and not timed.
+ */
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+double ratio(unsigned int order, int keep, int comp_count) {
+    return comp_count > 0 ? (2 * (order - (double) keep) + 1) / (2.0 * comp_count) : no_cut_toughness;
+}
+
+double scan_table(const graph_kernels &kernels, const mask_t *adjacency,
+                  const std::vector<std::pair<int, std::vector<mask_t>>> &subset_masks, unsigned int pair1,
+                  unsigned int pair2) {
+    double tough = no_cut_toughness;
+    mask_t pairs = mask_t(1) << pair1 | mask_t(1) << pair2;
+    for (const auto &kv : subset_masks) {
+        for (mask_t alive : kv.second) {
+            tough = std::min(tough, kernels.toughness(adjacency, alive, pairs));
+        }
+    }
+    return tough;
+}
+
+double scan_batch(const mask_t *adjacency, unsigned int order,
+                  const std::vector<std::pair<int, std::vector<mask_t>>> &subset_masks, unsigned int pair1,
+                  unsigned int pair2) {
+    double tough = no_cut_toughness;
+    int components[max_cut_batch];
+    unsigned char flags[max_cut_batch];
+    for (const auto &kv : subset_masks) {
+        for (std::size_t offset = 0; offset < kv.second.size(); offset += max_cut_batch) {
+            std::size_t count = std::min(max_cut_batch, kv.second.size() - offset);
+            count_components_batch(adjacency, order, &kv.second[offset], count, pair1, pair2, components, flags);
+            for (std::size_t c = 0; c < count; c++) {
+                tough = std::min(tough, ratio(order, kv.first, omega_prime(components[c], flags[c])));
+            }
+        }
+    }
+    return tough;
+}
+
+double scan_gray(const mask_t *adjacency, unsigned int order, unsigned int pair1, unsigned int pair2) {
+    double tough = no_cut_toughness;
+    GrayCodeCuts gray_cuts(adjacency, order);
+    for (unsigned int keep = 2; keep < order; keep++) {
+        gray_cuts.for_each(keep, [&](mask_t, const GrayCodeCuts &cuts) {
+            tough = std::min(tough, ratio(order, keep, cuts.omega_prime(pair1, pair2)));
+            return false;
+        });
+    }
+    return tough;
+}
+
+template<class Scan>
+double time_ns(int repetitions, Scan scan, double &result) {
+    auto start = clock_type::now();
+    for (int i = 0; i < repetitions; i++) {
+        result = scan();
+    }
+    return std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / repetitions;
+}
+
+}
+
+int main() {
+    std::mt19937 rng(2021);
+    std::bernoulli_distribution coin_dist{0.5};
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "batch kernel: " << cut_batch_isa_name(get_cut_batch_isa()) << std::endl;
+    std::cout << "order,cuts,table_ns_per_cut,batch_ns_per_cut,gray_ns_per_cut" << std::endl;
+    for (unsigned int order = 8; order <= 16; order++) {
+        std::vector<mask_t> adjacency(order, 0);
+        for (unsigned int j = 1; j < order; j++) {
+            for (unsigned int i = 0; i < j; i++) {
+                if (coin_dist(rng)) {
+                    adjacency[i] |= mask_t(1) << j;
+                    adjacency[j] |= mask_t(1) << i;
+                }
+            }
+        }
+        std::vector<std::pair<int, std::vector<std::vector<bool>>>> subsets;
+        for (unsigned int i = 2; i < order; i++) {
+            subsets.emplace_back(i, EnumerationAlgorithm::get_sets(order, i));
+        }
+        auto subset_masks = EnumerationAlgorithm::get_set_masks(subsets);
+        double cuts = 0;
+        for (const auto &kv : subset_masks) {
+            cuts += kv.second.size();
+        }
+        int repetitions = std::max(1, int(2e6 / cuts));
+        const graph_kernels &kernels = *find_kernels(order);
+        double table_result, batch_result, gray_result;
+        double table_ns = time_ns(repetitions, [&] {
+            return scan_table(kernels, adjacency.data(), subset_masks, 0, order - 1);
+        }, table_result);
+        double batch_ns = time_ns(repetitions, [&] {
+            return scan_batch(adjacency.data(), order, subset_masks, 0, order - 1);
+        }, batch_result);
+        double gray_ns = time_ns(repetitions, [&] {
+            return scan_gray(adjacency.data(), order, 0, order - 1);
+        }, gray_result);
+        if (table_result != batch_result or table_result != gray_result) {
+            std::cerr << "The cut orders disagree on order " << order << std::endl;
+            return 1;
+        }
+        std::cout << order << "," << cuts << "," << table_ns / cuts << "," << batch_ns / cuts << ","
+                  << gray_ns / cuts << std::endl;
+    }
+    return 0;
+}
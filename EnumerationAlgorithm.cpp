@@ -1,8 +1,156 @@
 #include "EnumerationAlgorithm.h"
+#include <algorithm>
 #include <iostream>
 #include <boost/graph/graphviz.hpp>
 #include <boost/function.hpp>
 #include "EnumerationGraph.h"
+#include "GraphGenerator.h"
+#include "ResultStore.h"
+#include "SolveStats.h"
+
+namespace {
+
+/**
+ * Prints the counterexamples of a solved graph: its graph6 string and the pair, for every pair without a witness.
+ */
+void print_counterexamples(const std::string &graph6, const witness_table &witnesses) {
+    std::size_t pair_index = 0;
+    for (std::size_t pair1 = 0; pair1 + 1 < witnesses.order; pair1++) {
+        for (std::size_t pair2 = pair1 + 1; pair2 < witnesses.order; pair2++, pair_index++) {
+            if (witnesses.kinds[pair_index] == no_witness) {
+                std::cout << graph6 << " " << pair1 << " " << pair2 << std::endl;
+            }
+        }
+    }
+}
+
+/**
+ * The ratio (2|S| + 1) / (2 omega') of a stored cut.
+ */
+double stored_ratio(unsigned int order, const stored_pair &pair) {
+    return (2 * (order - (double) __builtin_popcount(pair.alive)) + 1) / (2.0 * pair.components);
+}
+
+/**
+ * Reproduces the results of a graph from the store, if it holds the graph for this subset table: a stored Hamilton
+ * path is a path witness, a stored cut is a cut witness if its ratio is below toughness_test, and the other pairs are
+ * the counterexamples. As the stored cuts have the lowest ratio of the table, this is what solve finds (up to which
+ * witness), for every toughness_test. An open cut whose ratio is not below toughness_test does not decide its pair, as
+ * the pair was never searched for a Hamilton path; then the graph has to be solved.
+ * On success, witnesses holds the stored witnesses (as if solve was called). Otherwise stored holds the record of the
+ * graph, or has order 0 if there is none.
+ * @return whether the graph was resolved from the store
+ */
+bool solve_from_store(ResultStore &store, const std::string &graph6, unsigned char table, double toughness_test,
+                      stored_graph &stored, witness_table &witnesses) {
+    stored.order = 0;
+    if (not store.lookup(graph6, table, stored)) {
+        return false;
+    }
+    unsigned int order = stored.order;
+    for (const auto &pair : stored.pairs) {
+        if (pair.kind == stored_open_cut and stored_ratio(order, pair) >= toughness_test) {
+            return false;
+        }
+    }
+    witnesses.reset(order);
+    std::size_t pair_index = 0;
+    for (std::size_t pair1 = 0; pair1 + 1 < order; pair1++) {
+        for (std::size_t pair2 = pair1 + 1; pair2 < order; pair2++, pair_index++) {
+            auto &pair = stored.pairs[pair_index];
+            if (pair.kind == stored_path) {
+                witnesses.kinds[pair_index] = path_witness;
+                witnesses.paths[pair_index].swap(pair.path);
+            } else if ((pair.kind == stored_cut or pair.kind == stored_open_cut) and
+                       stored_ratio(order, pair) < toughness_test) {
+                witnesses.kinds[pair_index] = cut_witness;
+                witnesses.set_sizes[pair_index] = __builtin_popcount(pair.alive);
+                to_subset(pair.alive, order, witnesses.cuts[pair_index]);
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Stores the results of solve, merged with the record found by solve_from_store (previous, of order 0 if there is
+ * none). Every pair without a Hamilton path gets the cut of lowest ratio in subset_masks (see
+ * EnumerationGraph::min_cuts). A pair that solve resolved by a cut is not searched for a Hamilton path, it is stored
+ * as an open cut, unless it is known to have none: the record says so, or the ratio of the cut is below 1, so
+ * omega' >= |S| + 1 and no Hamilton path can pass the pair.
+ */
+void add_to_store(ResultStore &store, const std::string &graph6, unsigned char table, EnumerationGraph &graph,
+                  const subset_masks_t &subset_masks, const witness_table &witnesses, stored_graph &previous) {
+    unsigned int order = graph.graph_size;
+    std::size_t pair_count = order * (order - 1) / 2;
+    bool merge = previous.order == order;
+    stored_graph stored{order, table, std::vector<stored_pair>(pair_count)};
+    std::vector<double> ratios(pair_count, 0);
+    bool scan = false;
+    for (std::size_t pair_index = 0; pair_index < pair_count; pair_index++) {
+        stored_pair &pair = stored.pairs[pair_index];
+        if (witnesses.kinds[pair_index] == path_witness) {
+            pair.kind = stored_path;
+            pair.path = witnesses.paths[pair_index];
+        } else if (merge and previous.pairs[pair_index].kind == stored_path) {
+            pair.kind = stored_path;
+            pair.path.swap(previous.pairs[pair_index].path);
+        } else if (merge) {
+            // the lowest cut is stored already, and a pair without a path stays without one
+            pair = previous.pairs[pair_index];
+            if (pair.kind == stored_open_cut and witnesses.kinds[pair_index] == no_witness) {
+                pair.kind = stored_cut;
+            }
+        } else {
+            ratios[pair_index] = no_cut_toughness;
+            scan = true;
+        }
+    }
+    if (scan) {
+        std::vector<mask_t> alive;
+        std::vector<int> components;
+        graph.min_cuts(subset_masks, ratios, alive, components);
+        for (std::size_t pair_index = 0; pair_index < pair_count; pair_index++) {
+            stored_pair &pair = stored.pairs[pair_index];
+            if (ratios[pair_index] == 0) {
+                continue;
+            }
+            if (ratios[pair_index] == no_cut_toughness) {
+                pair.kind = stored_no_cut;
+                continue;
+            }
+            pair.kind = witnesses.kinds[pair_index] == no_witness or ratios[pair_index] < 1 ? stored_cut
+                                                                                            : stored_open_cut;
+            pair.alive = alive[pair_index];
+            pair.components = components[pair_index];
+        }
+    }
+    store.put(graph6, stored);
+}
+
+/**
+ * Prepares the arena of this thread for a new run: the witnesses of an earlier run are not used as previous witnesses
+ * (but keep their memory), and the graph gets the toughness_test of this run.
+ */
+solve_arena &start_run(double toughness_test) {
+    solve_arena &arena = thread_solve_arena();
+    arena.previous.order = 0;
+    arena.graph.set_toughness_test(toughness_test);
+    return arena;
+}
+
+/**
+ * The store only holds graphs that have kernels, for other orders it is not used.
+ */
+ResultStore *usable_store(ResultStore *store, int graph_size) {
+    if (store and not find_kernels(graph_size)) {
+        std::cerr << "The result store is not supported for graphs of order " << graph_size << std::endl;
+        return nullptr;
+    }
+    return store;
+}
+
+}
 
 /**
  * This function creates all possible subsets of a set {0, 1, 2, ..., length-1}. The subsets are returned in binary
@@ -18,6 +166,49 @@ std::vector<std::vector<bool>> EnumerationAlgorithm::get_sets(unsigned int lengt
     return subsets;
 }
 
+/**
+ * The subsets of the given table (set_size_table or all_sizes_table) for graphs of this order, per subset size.
+ */
+std::vector<std::pair<int, std::vector<std::vector<bool>>>> EnumerationAlgorithm::get_subset_table(
+        unsigned int order, unsigned char table) {
+    std::vector<std::pair<int, std::vector<std::vector<bool>>>> subsets;
+    if (table == set_size_table) {
+        for (auto set_size : get_set_size(order)) {
+            subsets.emplace_back(set_size, get_sets(order, set_size));
+        }
+    } else if (table == all_sizes_table) {
+        // note that these are too many for chordal graphs
+        // can be optimised based on section 4.5.2 of my report depending on toughness_test and graph order
+        for (unsigned int i = 2; i < order; i++) {
+            subsets.emplace_back(i, get_sets(order, i));
+        }
+    } else {
+        throw std::invalid_argument("Unknown subset table");
+    }
+    return subsets;
+}
+
+/**
+ * Converts the subsets returned by get_sets to bitmasks, in the same order, for use by the graph kernels.
+ * Returns an empty table if the order has no kernels (see find_kernels).
+ */
+std::vector<std::pair<int, std::vector<mask_t>>> EnumerationAlgorithm::get_set_masks(
+        const std::vector<std::pair<int, std::vector<std::vector<bool>>>> &subsets) {
+    std::vector<std::pair<int, std::vector<mask_t>>> subset_masks;
+    if (subsets.empty() or not find_kernels(subsets.front().second.front().size())) {
+        return subset_masks;
+    }
+    for (const auto &kv : subsets) {
+        std::vector<mask_t> masks;
+        masks.reserve(kv.second.size());
+        for (const auto &subset : kv.second) {
+            masks.push_back(to_mask(subset));
+        }
+        subset_masks.emplace_back(kv.first, std::move(masks));
+    }
+    return subset_masks;
+}
+
 //
 /**
  * Return sets requires to analyse to test tough < 2,
@@ -69,26 +260,41 @@ std::vector<std::vector<bool>> EnumerationAlgorithm::get_less_sets(
  * Performs the enumeration algorithm.
  * This method assumes all the graphs have the same order (to avoid redundant calls to get_sets)
  * It is also assumes the g6 format and that no header is present!
+ * If a store is passed, graphs whose results are in the store are not solved again, and new results are added to it.
  */
-void EnumerationAlgorithm::readFile(const std::string &filename, double toughness_test) {
+void EnumerationAlgorithm::readFile(const std::string &filename, double toughness_test, ResultStore *store) {
     std::ifstream infile(filename);
     if (!infile) {
         std::cerr << "The file doesn't exist" << std::endl;
     } else {
         int graph_size = infile.peek() - 63;
-        std::vector<std::pair<int, std::vector<std::vector<bool>>>> subsets;
-        for (auto set_size : get_set_size(graph_size)) {
-            subsets.emplace_back(set_size, get_sets(graph_size, set_size));
-        }
+        auto subsets = get_subset_table(graph_size, set_size_table);
+        subset_masks_t subset_masks = get_set_masks(subsets);
+        store = usable_store(store, graph_size);
         std::string line;
-        ham_map_t ham_map;
-        cut_set_map_t cut_set_map;
+        stored_graph stored{};
+        solve_arena &arena = start_run(toughness_test);
+        TNH_RUN(stats);
         while (std::getline(infile, line)) {
-            EnumerationGraph my_graph(line, toughness_test);
-            if (not my_graph.hasCompleteClosure(graph_size + 1)) {
-                std::tie(ham_map, cut_set_map) = my_graph.solve(subsets, ham_map, cut_set_map);
+            TNH_PROGRESS(stats);
+            if (store and solve_from_store(*store, line, set_size_table, toughness_test, stored, arena.witnesses)) {
+                print_counterexamples(line, arena.witnesses);
+                arena.next_graph();
+                continue;
+            }
+            arena.graph.load(line);
+            if (not arena.graph.hasCompleteClosure(graph_size + 1)) {
+                arena.graph.solve(subsets, subset_masks, arena.previous, arena.witnesses);
+                print_counterexamples(line, arena.witnesses);
+                if (store) {
+                    add_to_store(*store, line, set_size_table, arena.graph, subset_masks, arena.witnesses, stored);
+                }
+                arena.next_graph();
+            } else {
+                TNH_COUNT(event_closure_rejected);
             }
         }
+        TNH_SUMMARY(stats);
     }
 }
 
@@ -99,27 +305,76 @@ void EnumerationAlgorithm::readFile(const std::string &filename, double toughnes
  * This method assumes all the graphs have the same order (to avoid redundant calls to get_sets)
  * It is also assumes the g6 format and that no header is present!
  * Use toughness_test=1.751 to exclude graphs of order 1.75
+ * If a store is passed, it is used as in readFile.
  */
-void EnumerationAlgorithm::readChordalFile(const std::string &filename, double toughness_test) {
+void EnumerationAlgorithm::readChordalFile(const std::string &filename, double toughness_test, ResultStore *store) {
     std::ifstream infile(filename);
     if (!infile) {
         std::cerr << "The file doesn't exist" << std::endl;
     } else {
         int graph_size = infile.peek() - 63;
-        std::vector<std::pair<int, std::vector<std::vector<bool>>>> subsets;
-        // note that these are too many for chordal graphs
-        // can be optimised based on section 4.5.2 of my report depending on toughness_test and graph order
-        for (size_t i = 2; i < graph_size; i++) {
-            subsets.emplace_back(i, get_sets(graph_size, i));
-        }
+        auto subsets = get_subset_table(graph_size, all_sizes_table);
+        subset_masks_t subset_masks = get_set_masks(subsets);
+        store = usable_store(store, graph_size);
         std::string line;
-        ham_map_t ham_map;
-        cut_set_map_t cut_set_map;
+        stored_graph stored{};
+        solve_arena &arena = start_run(toughness_test);
+        TNH_RUN(stats);
         while (std::getline(infile, line)) {
-            EnumerationGraph my_graph(line, toughness_test);
-            if (not my_graph.hasCompleteClosure(graph_size + 1)) {
-                std::tie(ham_map, cut_set_map) = my_graph.solve(subsets, ham_map, cut_set_map);
+            TNH_PROGRESS(stats);
+            if (store and solve_from_store(*store, line, all_sizes_table, toughness_test, stored, arena.witnesses)) {
+                print_counterexamples(line, arena.witnesses);
+                arena.next_graph();
+                continue;
+            }
+            arena.graph.load(line);
+            if (not arena.graph.hasCompleteClosure(graph_size + 1)) {
+                arena.graph.solve(subsets, subset_masks, arena.previous, arena.witnesses);
+                print_counterexamples(line, arena.witnesses);
+                if (store) {
+                    add_to_store(*store, line, all_sizes_table, arena.graph, subset_masks, arena.witnesses, stored);
+                }
+                arena.next_graph();
+            } else {
+                TNH_COUNT(event_closure_rejected);
             }
         }
+        TNH_SUMMARY(stats);
     }
-}
\ No newline at end of file
+}
+
+/**
+ * Performs the enumeration algorithm on the connected graphs of the given order, generated in memory by
+ * GraphGenerator instead of read from a geng file. Graphs with a complete closure or a vertex of degree below
+ * min_degree are pruned during generation, and res/mod select a part of the graphs as in geng, such that mod runs
+ * (e.g. in parallel) together cover every graph once. Counterexamples are printed with their canonical graph6 string.
+ * If a store is passed, it is used as in readFile.
+ */
+void EnumerationAlgorithm::enumerateGraphs(unsigned int order, double toughness_test, unsigned int min_degree,
+                                           unsigned int res, unsigned int mod, ResultStore *store) {
+    auto subsets = get_subset_table(order, set_size_table);
+    subset_masks_t subset_masks = get_set_masks(subsets);
+    solve_arena &arena = start_run(toughness_test);
+    stored_graph stored{};
+    GraphGenerator generator(order, min_degree, order + 1, res, mod);
+    TNH_RUN(stats);
+    generator.generate([&](const mask_t *adjacency) {
+        TNH_PROGRESS(stats);
+        arena.graph.load(adjacency, order);
+        const std::string &graph6 = arena.graph.get_name();
+        if (store and solve_from_store(*store, graph6, set_size_table, toughness_test, stored, arena.witnesses)) {
+            print_counterexamples(graph6, arena.witnesses);
+            arena.next_graph();
+            return;
+        }
+        // the generator only passes graphs without a complete closure, solve runs on the closure
+        arena.graph.hasCompleteClosure(order + 1);
+        arena.graph.solve(subsets, subset_masks, arena.previous, arena.witnesses);
+        print_counterexamples(graph6, arena.witnesses);
+        if (store) {
+            add_to_store(*store, graph6, set_size_table, arena.graph, subset_masks, arena.witnesses, stored);
+        }
+        arena.next_graph();
+    });
+    TNH_SUMMARY(stats);
+}
@@ -3,14 +3,26 @@
 
 #include <string>
 #include <vector>
+#include "GraphKernels.h"
+
+class ResultStore;
 
 class EnumerationAlgorithm {
     static std::vector<std::vector<bool>> get_less_sets(unsigned int length, unsigned int subset_size, unsigned int u, unsigned int v);
     static std::vector<int> get_set_size(int order);
 public:
+    // Subset tables, recorded with the results in a ResultStore
+    static constexpr unsigned char set_size_table = 0;   // the sizes of get_set_size, used by readFile
+    static constexpr unsigned char all_sizes_table = 1;  // all sizes, used by readChordalFile
     static std::vector<std::vector<bool>> get_sets(unsigned int length, unsigned int subset_size);
-    static void readFile(const std::string &filename, double toughnesstest=2);
-    static void readChordalFile(const std::string &filename, double toughnesstest=1.75);
+    static std::vector<std::pair<int, std::vector<std::vector<bool>>>> get_subset_table(unsigned int order,
+                                                                                        unsigned char table);
+    static std::vector<std::pair<int, std::vector<mask_t>>> get_set_masks(
+            const std::vector<std::pair<int, std::vector<std::vector<bool>>>> &subsets);
+    static void readFile(const std::string &filename, double toughnesstest=2, ResultStore *store=nullptr);
+    static void readChordalFile(const std::string &filename, double toughnesstest=1.75, ResultStore *store=nullptr);
+    static void enumerateGraphs(unsigned int order, double toughness_test=2, unsigned int min_degree=1,
+                                unsigned int res=0, unsigned int mod=1, ResultStore *store=nullptr);
 };
 
 
@@ -1,29 +1,103 @@
 #include "EnumerationGraph.h"
+#include "CutBatch.h"
+#include "GrayCodeCuts.h"
+#include "SolveStats.h"
 #include <boost/graph/connected_components.hpp>
-#include <iostream>
+#include <array>
+#include <stdexcept>
+
+/**
+ * Marks every pair as unsolved, keeping the paths and cuts of a previous graph of the same order allocated.
+ */
+void witness_table::reset(unsigned int graph_order) {
+    order = graph_order;
+    std::size_t pair_count = order * (order - 1) / 2;
+    kinds.assign(pair_count, no_witness);
+    paths.resize(pair_count);
+    set_sizes.resize(pair_count);
+    cuts.resize(pair_count);
+    scanned_cuts.clear();
+}
+
+/**
+ * The arena of the calling thread, see solve_arena.
+ */
+solve_arena &thread_solve_arena() {
+    static thread_local solve_arena arena;
+    return arena;
+}
+
+/**
+ * An empty graph, to be filled by load.
+ */
+EnumerationGraph::EnumerationGraph(double t_test) {
+    toughness_test = t_test;
+}
 
 /**
  * This constructor decodes the graph6 format: http://users.cecs.anu.edu.au/~bdm/data/formats.txt
- * It assumes the graph is smaller than 64 nodes and the files contains no header!
+ * Orders of 63 and above use the long form of the order, it is assumed the files contains no header!
+ */
+EnumerationGraph::EnumerationGraph(const std::string &graph_string, double t_test) {
+    toughness_test = t_test;
+    load(graph_string);
+}
+
+/**
+ * Creates the graph from an adjacency table, e.g. one produced by GraphGenerator, without a graph6 round trip.
+ * The order must have kernels (see find_kernels).
  */
-EnumerationGraph::EnumerationGraph(std::string graph_string, double t_test) {
-    graph_name = graph_string;
-    graph_size = int(graph_string[0]) - 63; // size < 64!
-    graph_string.erase(graph_string.begin());
+EnumerationGraph::EnumerationGraph(const mask_t *adjacency_table, unsigned int order, double t_test) {
     toughness_test = t_test;
+    load(adjacency_table, order);
+}
 
+/**
+ * Removes all edges and sets the order. Orders with kernels keep their edges in the bitmask adjacency only, so that
+ * reloading a graph of the same order reuses all memory; the boost graph only holds the vertices then.
+ */
+void EnumerationGraph::clear_graph(unsigned int order) {
+    if (order == graph_size and kernels) {
+        std::fill(adjacency.begin(), adjacency.end(), 0);
+        return;
+    }
+    g.clear();
+    vertices.clear();
+    graph_size = order;
     vertices.reserve(graph_size);
     for (size_t i = 0; i < graph_size; i++) {
         vertices.push_back(add_vertex(g));
     }
+    select_kernels();
+    boost_edges = kernels == nullptr;
+}
+
+/**
+ * Replaces the graph by the one in graph_string, in graph6 format (see the constructor).
+ */
+void EnumerationGraph::load(const std::string &graph_string) {
+    load(graph_string.data(), graph_string.size());
+}
+
+/**
+ * Replaces the graph by the one in the graph6 string of the given length, which need not be null terminated.
+ */
+void EnumerationGraph::load(const char *graph_string, std::size_t length) {
+    graph_name.assign(graph_string, length);
+    std::size_t body;
+    clear_graph(graph6_order(graph_name.data(), length, body));
+    if (kernels) {
+        kernels->decode_graph6(graph_name.data() + body, adjacency.data());
+        return;
+    }
 
     int outer_counter = 1;
     int inner_counter = 0;
-    for (char &c : graph_string) {
-        std::bitset<6> bs(int(c) - 63);
+    for (auto c = graph_name.begin() + body; c != graph_name.end(); c++) {
+        std::bitset<6> bs(int(*c) - 63);
         for (std::size_t i = bs.size(); i-- > 0;) {
             if (bs[i]) {
-                add_edge(vertices[outer_counter], vertices[inner_counter], g);
+                add_graph_edge(vertices[outer_counter], vertices[inner_counter]);
             }
             if (inner_counter == outer_counter - 1) {
                 outer_counter++;
@@ -36,61 +110,119 @@ EnumerationGraph::EnumerationGraph(std::string graph_string, double t_test) {
 }
 
 /**
- * This function checks the desired criteria of the graph, and prints a counterexample (graph name + pair
- * of vertices) if it is found.
+ * Replaces the graph by the one given by an adjacency table, the order must have kernels.
+ */
+void EnumerationGraph::load(const mask_t *adjacency_table, unsigned int order) {
+    if (not find_kernels(order)) {
+        throw std::invalid_argument("Adjacency tables are only supported for orders with kernels");
+    }
+    to_graph6(adjacency_table, order, graph_name);
+    clear_graph(order);
+    std::copy(adjacency_table, adjacency_table + order, adjacency.begin());
+}
+
+/**
+ * This function checks the desired criteria of the graph: for every pair it finds a Hamilton path or a cut of low
+ * toughness. The pairs without either are the counterexamples, their kind stays no_witness.
   * @param subset_pairs contains the sets used to calculate the toughness
-  * @param prev_ham_map is a hashmap containing useful hamilton path of the previous graph
-  * @param prev_cut_set_map is a hashmap containing useful cuts of the previous graph
-  * @return
+  * @param subset_masks contains the same sets as bitmasks, used when this order has kernels (may be empty otherwise)
+  * @param previous contains the witnesses of the previous graph, its paths and cuts are tried first
+  * @param witnesses is reset and receives the witnesses of this graph; with kernels, a table that was used for a graph
+  *        of this order before is filled without allocating
   */
-std::pair<ham_map_t, cut_set_map_t> EnumerationGraph::solve(const subset_pairs_t &subset_pairs,
-                                                            ham_map_t &prev_ham_map, cut_set_map_t &prev_cut_set_map) {
+void EnumerationGraph::solve(const subset_pairs_t &subset_pairs, const subset_masks_t &subset_masks,
+                             const witness_table &previous, witness_table &witnesses) {
 
-    //Define local variables
-    std::vector<bool> in_subgraph;
-    in_subgraph.resize(graph_size, true);
+    //Define local variables, the boost ones are only needed without kernels
+    std::vector<bool> in_subgraph(kernels ? 0 : graph_size, true);
+    std::vector<int> component(kernels ? 0 : graph_size);
     Filtered f(g, keep_all{}, [&](Vertex v) { return in_subgraph[v]; });
     bool low_tough = false;
-    ham_map_t ham_map;
-    cut_set_map_t cut_set_map;
-    std::unordered_map<int, std::vector<std::vector<bool>>> current_sets;
+    witnesses.reset(graph_size);
+    bool use_previous = previous.order == graph_size;
     std::size_t pair1;
     std::size_t pair2;
+    std::size_t pair_index;
 
     /**
-     *  Lambda function that calculates the toughness based on the cuts provided in arr,
-    *   set_size contains the size of the cuts in arr
-     *   write_cut_sets indicates whether a found solution is written to current_subsets
+     *  Lambda function that tests whether the cut keeping the vertices in row (set_size of them) has toughness below
+     *  toughness_test for the current pair.
      */
-    auto test_toughness = [&] (const std::vector<std::vector<bool>> &arr, const int set_size, bool write_cut_sets) {
-        std::vector<int> component(graph_size);
-        for (auto &row : arr) {  //loop over |S|
-            // update in_subgraph, which changes the filtered graph f
-            in_subgraph = row;
-            int comp_count = connected_components(f, &component[0]);
-
-            // Subtract 1 for each component containing pair1 or pair2.
-            if (in_subgraph[pair1]) {
-                if (in_subgraph[pair2]) {
-                    if (component[pair1] == component[pair2]) {
-                        comp_count--;
-                    } else {
-                        comp_count -= 2;
-                    }
-                } else {
+    auto low_toughness = [&] (const std::vector<bool> &row, const int set_size) {
+        if (kernels) {
+            mask_t pairs = mask_t(1) << pair1 | mask_t(1) << pair2;
+            return kernels->toughness(adjacency.data(), to_mask(row), pairs) < toughness_test;
+        }
+        // update in_subgraph, which changes the filtered graph f
+        in_subgraph = row;
+        int comp_count = connected_components(f, &component[0]);
+
+        // Subtract 1 for each component containing pair1 or pair2.
+        if (in_subgraph[pair1]) {
+            if (in_subgraph[pair2]) {
+                if (component[pair1] == component[pair2]) {
                     comp_count--;
+                } else {
+                    comp_count -= 2;
                 }
-            } else if (in_subgraph[pair2]) {
+            } else {
                 comp_count--;
             }
+        } else if (in_subgraph[pair2]) {
+            comp_count--;
+        }
 
-            if (comp_count > 0) {
-                // (2*|S| + 1) / (2 omega) < 2
-                if ((2 * (graph_size - (double) set_size) + 1) / (2.0 * comp_count) < toughness_test) {
-                    cut_set_map.emplace(std::make_pair(pair1, pair2), std::make_pair(set_size, in_subgraph));
-                    if (write_cut_sets) {
-                        current_sets[set_size].push_back(in_subgraph);
-                    }
+        // (2*|S| + 1) / (2 omega) < 2
+        return comp_count > 0 and (2 * (graph_size - (double) set_size) + 1) / (2.0 * comp_count) < toughness_test;
+    };
+
+    auto store_cut = [&] (const std::vector<bool> &row, const int set_size) {
+        witnesses.kinds[pair_index] = cut_witness;
+        witnesses.set_sizes[pair_index] = set_size;
+        witnesses.cuts[pair_index] = row;
+    };
+
+    /**
+     *  Lambda function that stores the cut alive found by scanning the subset tables, and remembers it for the other
+     *  pairs.
+     */
+    auto store_scanned_cut = [&] (mask_t alive, const int set_size) {
+        witnesses.kinds[pair_index] = cut_witness;
+        witnesses.set_sizes[pair_index] = set_size;
+        to_subset(alive, graph_size, witnesses.cuts[pair_index]);
+        witnesses.scanned_cuts.push_back(pair_index);
+    };
+
+    /**
+     *  Scans the cuts in arr (of size set_size) until one has toughness below toughness_test.
+     */
+    auto test_toughness = [&] (const std::vector<std::vector<bool>> &arr, const int set_size) {
+        for (auto &row : arr) {  //loop over |S|
+            if (low_toughness(row, set_size)) {
+                store_cut(row, set_size);
+                witnesses.scanned_cuts.push_back(pair_index);
+                return true;
+            }
+        }
+        return false;
+    };
+
+    /**
+     *  The same as test_toughness, for cuts given as bitmasks. The cuts are evaluated in batches, the first cut of arr
+     *  (in order) that is good enough is the one stored.
+     */
+    auto test_toughness_masks = [&] (const std::vector<mask_t> &arr, const int set_size) {
+        int components[max_cut_batch];
+        unsigned char flags[max_cut_batch];
+        for (size_t offset = 0; offset < arr.size(); offset += max_cut_batch) {
+            size_t count = std::min(max_cut_batch, arr.size() - offset);
+            count_components_batch(adjacency.data(), graph_size, &arr[offset], count, pair1, pair2, components,
+                                   flags);
+            for (size_t c = 0; c < count; c++) {
+                int comp_count = omega_prime(components[c], flags[c]);
+                if (comp_count > 0 and
+                        (2 * (graph_size - (double) set_size) + 1) / (2.0 * comp_count) < toughness_test) {
+                    store_scanned_cut(arr[offset + c], set_size);
                     return true;
                 }
             }
@@ -98,44 +230,69 @@ std::pair<ham_map_t, cut_set_map_t> EnumerationGraph::solve(const subset_pairs_t
         return false;
     };
 
+    /**
+     *  The same as test_toughness_masks, visiting all cuts of size graph_size - set_size in revolving door order
+     *  instead of table order, with the components updated incrementally.
+     */
+    GrayCodeCuts gray_cuts(adjacency.data(), graph_size);
+    auto test_toughness_gray = [&] (const int set_size) {
+        return gray_cuts.for_each(set_size, [&] (mask_t alive, const GrayCodeCuts &cuts) {
+            int comp_count = cuts.omega_prime(pair1, pair2);
+            if (comp_count > 0 and (2 * (graph_size - (double) set_size) + 1) / (2.0 * comp_count) < toughness_test) {
+                store_scanned_cut(alive, set_size);
+                return true;
+            }
+            return false;
+        });
+    };
+    bool gray_order = get_cut_order() == gray_cut_order;
+    TNH_COUNT(event_graphs);
+
     for (pair1 = 0; pair1 < graph_size - 1; pair1++) {
         for (pair2 = pair1 + 1; pair2 < graph_size; pair2++) {
-            std::pair<size_t, size_t> pair = std::make_pair(pair1, pair2);
+            pair_index = witnesses.pair_index(pair1, pair2);
+            TNH_PAIR_TIMER(timer);
 
+            // Check the cuts found for the previous pairs
             low_tough = false;
-            for (const auto &kv: current_sets) {
-                low_tough = test_toughness(kv.second, kv.first, false);
+            for (std::size_t scanned : witnesses.scanned_cuts) {
+                low_tough = low_toughness(witnesses.cuts[scanned], witnesses.set_sizes[scanned]);
                 if (low_tough) {
+                    store_cut(witnesses.cuts[scanned], witnesses.set_sizes[scanned]);
                     break;
                 }
             }
+            TNH_STAGE_END(timer, stage_current_sets, low_tough);
             if (low_tough) {
                 continue;
             }
 
             // Check ham_path of previous solution
-            auto iterator = prev_ham_map.find(pair);
-            if (iterator != prev_ham_map.end()) {
-                Path path = iterator -> second;
-                if (check_hamilton_path(path)) {
-                    ham_map.emplace(pair, path);
+            witness_kind previous_kind = use_previous ? previous.kinds[pair_index] : no_witness;
+            if (previous_kind == path_witness) {
+                const Path &path = previous.paths[pair_index];
+                bool valid_path = check_hamilton_path(path);
+                TNH_STAGE_END(timer, stage_prev_path, valid_path);
+                if (valid_path) {
+                    witnesses.kinds[pair_index] = path_witness;
+                    witnesses.paths[pair_index] = path;
                     continue;
                 }
-            } else {
-                auto value = prev_cut_set_map[pair];
-                int set_size;
-                std::vector<bool> subset;
-                std::tie(set_size, subset) = value;
-                auto subsets = {subset,};
-                low_tough = test_toughness(subsets, set_size, false);
+            } else if (previous_kind == cut_witness) {
+                low_tough = low_toughness(previous.cuts[pair_index], previous.set_sizes[pair_index]);
+                TNH_STAGE_END(timer, stage_prev_cut, low_tough);
                 if (low_tough) {
+                    store_cut(previous.cuts[pair_index], previous.set_sizes[pair_index]);
                     continue;
                 }
             }
 
-            Path path;
-            if (exists_hamilton_path_helper(vertices[pair1], vertices[pair2], path)) {
-                ham_map.emplace(pair, path);
+            Path &path = witnesses.paths[pair_index];
+            path.clear();
+            bool found_path = find_hamilton_path(vertices[pair1], vertices[pair2], path);
+            TNH_STAGE_END(timer, stage_path_search, found_path);
+            if (found_path) {
+                witnesses.kinds[pair_index] = path_witness;
                 continue;
             }
 //            Possible optimisation for graph of size 5,8,11,14,.... This should be removed from the other
@@ -145,16 +302,96 @@ std::pair<ham_map_t, cut_set_map_t> EnumerationGraph::solve(const subset_pairs_t
 //                    continue;
 //                }
 
-            for (const auto &kv: subset_pairs) {
-                low_tough = test_toughness(kv.second, kv.first, true);
-                if (low_tough) {
-                    break;
+            if (kernels) {
+                for (const auto &kv: subset_masks) {
+                    low_tough = gray_order ? test_toughness_gray(kv.first) : test_toughness_masks(kv.second, kv.first);
+                    if (low_tough) {
+                        break;
+                    }
+                }
+            } else {
+                for (const auto &kv: subset_pairs) {
+                    low_tough = test_toughness(kv.second, kv.first);
+                    if (low_tough) {
+                        break;
+                    }
                 }
             }
+            TNH_STAGE_END(timer, stage_full_scan, low_tough);
             if (not low_tough) {
-                std::cout << graph_name << " " << pair1 << " " << pair2 << std::endl;
+                TNH_COUNT(event_counterexamples);
+            }
+        }
+    }
+}
+
+
+/**
+ * Counts the components of the graph induced by subset that contain neither pair1 nor pair2 (omega' of the cut).
+ * Only available for orders that have kernels.
+ */
+int EnumerationGraph::cut_components(std::size_t pair1, std::size_t pair2, const std::vector<bool> &subset) const {
+    return kernels->count_components(adjacency.data(), to_mask(subset), mask_t(1) << pair1 | mask_t(1) << pair2);
+}
+
+/**
+ * Scans every cut of the subset tables once and finds, for the requested pairs, the lowest (2|S| + 1) / (2 omega'), or
+ * no_cut_toughness if no cut leaves a component without the pair. Only available for orders that have kernels.
+ * The results are indexed by pair index (see witness_table::pair_index).
+ * @param ratios on entry no_cut_toughness for the pairs to scan and 0 for the others, receives the lowest ratios
+ * @param alive receives the vertices not in the cut of the lowest ratio
+ * @param components receives omega' of that cut
+ */
+void EnumerationGraph::min_cuts(const subset_masks_t &subset_masks, std::vector<double> &ratios,
+                                std::vector<mask_t> &alive, std::vector<int> &components) const {
+    std::size_t pair_count = graph_size * (graph_size - 1) / 2;
+    alive.assign(pair_count, 0);
+    components.assign(pair_count, 0);
+    std::array<int, max_kernel_order> label{};
+    double highest = no_cut_toughness;  // the highest ratio of a pair so far, cuts that cannot beat it are skipped
+    for (const auto &kv : subset_masks) {
+        double cut_size = graph_size - (double) kv.first;
+        for (mask_t cut_alive : kv.second) {
+            int comp_count = kernels->count_components(adjacency.data(), cut_alive, 0);
+            if (comp_count == 0 or (2 * cut_size + 1) / (2.0 * comp_count) >= highest) {
+                continue;
+            }
+            // label the components of the kept vertices, -1 for the cut
+            label.fill(-1);
+            int component_label = 0;
+            for (mask_t rest = cut_alive; rest; component_label++) {
+                mask_t component = rest & (~rest + 1);
+                mask_t previous = 0;
+                while (component != previous) {
+                    previous = component;
+                    for (mask_t frontier = component; frontier; frontier &= frontier - 1) {
+                        component |= adjacency[kernels::lowest(frontier)] & cut_alive;
+                    }
+                }
+                for (mask_t members = component; members; members &= members - 1) {
+                    label[kernels::lowest(members)] = component_label;
+                }
+                rest &= ~component;
+            }
+            // the ratio if the pair lies in none, one or two of the components
+            double ratio_of[3];
+            for (int in_pair = 0; in_pair < 3; in_pair++) {
+                ratio_of[in_pair] = comp_count > in_pair ? (2 * cut_size + 1) / (2.0 * (comp_count - in_pair))
+                                                         : no_cut_toughness;
+            }
+            highest = 0;
+            std::size_t pair_index = 0;
+            for (std::size_t pair1 = 0; pair1 + 1 < graph_size; pair1++) {
+                for (std::size_t pair2 = pair1 + 1; pair2 < graph_size; pair2++, pair_index++) {
+                    int in_pair = (label[pair1] >= 0) + (label[pair2] >= 0 and label[pair2] != label[pair1]);
+                    if (ratio_of[in_pair] < ratios[pair_index]) {
+                        ratios[pair_index] = ratio_of[in_pair];
+                        alive[pair_index] = cut_alive;
+                        components[pair_index] = comp_count - in_pair;
+                    }
+                    highest = std::max(highest, ratios[pair_index]);
+                }
             }
         }
     }
-    return std::make_pair(ham_map, cut_set_map);
 }
@@ -4,27 +4,71 @@
 
 #include "Graph.h"
 
-struct hash_pair {
-    template<class T1, class T2>
-    size_t operator()(const std::pair<T1, T2> &p) const {
-        auto hash1 = hash<T1>{}(p.first);
-        auto hash2 = hash<T2>{}(p.second);
-        return hash1 ^ hash2;
-    }
+using subset_pairs_t = std::vector<std::pair<int, std::vector<std::vector<bool>>>>;
+using subset_masks_t = std::vector<std::pair<int, std::vector<mask_t>>>;
+
+enum witness_kind : unsigned char {
+    no_witness,    // neither was found (a counterexample, or the pair was not solved)
+    path_witness,  // a Hamilton path between the pair
+    cut_witness    // a cut with (2|S| + 1) / (2 omega') < toughness_test
 };
 
-using ham_map_t = std::unordered_map<std::pair<int, int>, Path, hash_pair>;
-using cut_set_map_t = std::unordered_map<std::pair<int, int>, std::pair<int, std::vector<bool>>, hash_pair>;
-using subset_pairs_t = std::vector<std::pair<int, std::vector<std::vector<bool>>>>;
+/**
+ * The witnesses solve found for the pairs of one graph, indexed by pair_index: per pair a Hamilton path (from pair1
+ * to pair2) or a cut (the kept vertices and their number, as in the subset tables).
+ * reset keeps every path and cut with its capacity, such that a table reused for graphs of the same order stops
+ * allocating once it has been filled. The tables of consecutive graphs are swapped, never copied.
+ */
+struct witness_table {
+    unsigned int order = 0;
+    std::vector<witness_kind> kinds;
+    std::vector<Path> paths;
+    std::vector<int> set_sizes;
+    std::vector<std::vector<bool>> cuts;
+    // pairs whose cut was found by scanning the subset tables, these cuts are tried first for the later pairs
+    std::vector<std::size_t> scanned_cuts;
+
+    void reset(unsigned int graph_order);
+    std::size_t pair_index(std::size_t pair1, std::size_t pair2) const {
+        return pair1 * (2 * order - pair1 - 1) / 2 + pair2 - pair1 - 1;
+    }
+};
 
 class EnumerationGraph : public Graph {
     double toughness_test;
 
+    void clear_graph(unsigned int order);
 public:
-    EnumerationGraph(std::string graph_string, double t_test);
-    std::pair<ham_map_t, cut_set_map_t> solve(const subset_pairs_t &subset_pairs, ham_map_t &prev_ham_map,
-                                              cut_set_map_t &write_cut_sets);
+    explicit EnumerationGraph(double t_test=2);
+    EnumerationGraph(const std::string &graph_string, double t_test);
+    EnumerationGraph(const mask_t *adjacency_table, unsigned int order, double t_test);
+    void load(const std::string &graph_string);
+    void load(const char *graph_string, std::size_t length);
+    void load(const mask_t *adjacency_table, unsigned int order);
+    const std::string &get_name() const { return graph_name; }
+    void set_toughness_test(double t_test) { toughness_test = t_test; }
+    void solve(const subset_pairs_t &subset_pairs, const subset_masks_t &subset_masks, const witness_table &previous,
+               witness_table &witnesses);
+    int cut_components(std::size_t pair1, std::size_t pair2, const std::vector<bool> &subset) const;
+    void min_cuts(const subset_masks_t &subset_masks, std::vector<double> &ratios, std::vector<mask_t> &alive,
+                  std::vector<int> &components) const;
+};
+
+/**
+ * The graph and witness tables one thread reuses for every graph it solves, such that solving a stream of graphs of
+ * the same order does not allocate once the first graphs have been solved. After solving a graph, next_graph makes its
+ * witnesses the previous ones of the next graph.
+ */
+struct solve_arena {
+    EnumerationGraph graph;
+    witness_table previous, witnesses;
+
+    void next_graph() {
+        std::swap(previous, witnesses);
+    }
 };
 
+solve_arena &thread_solve_arena();
+
 
 #endif //REFACTORED_THESIS_ENUMERATIONGRAPH_H
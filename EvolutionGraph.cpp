@@ -6,6 +6,8 @@
 #include <iostream>
 #include <boost/graph/copy.hpp>
 #include "EvolutionGraph.h"
+#include "CutBatch.h"
+#include "GrayCodeCuts.h"
 
 EvolutionGraph::EvolutionGraph() = default;
 
@@ -13,59 +15,83 @@ EvolutionGraph::EvolutionGraph() = default;
 /**
  * Constructor for the initial population of the EA.
  * Creates a graph of order n, where each possible edge is chosen to be included in the graph with probability prob.
+ * The edges are drawn with the given seed, by default a random one. Orders up to max_wide_order are supported.
  */
-EvolutionGraph::EvolutionGraph(int size, double prob) {
+EvolutionGraph::EvolutionGraph(int size, double prob, unsigned int seed) {
+    if (size > int(max_wide_order)) {
+        throw std::invalid_argument("Orders above " + std::to_string(max_wide_order) + " are not supported");
+    }
     graph_size = size;
     vertices.reserve(graph_size);
     for (size_t i = 0; i < graph_size; i++) {
         vertices.push_back(add_vertex(g));
     }
-    std::random_device dev;  // seed the random number generator
-    std::mt19937 rng(dev());
+    select_kernels(max_scanned_order + 1);
+    std::mt19937 rng(seed);
 
     std::bernoulli_distribution coin_dist{prob};
 
-    std::string g6string(1, (char) graph_size + 63);
-    std::bitset<6> my_bit;
-    size_t current_bit = 6;
     for (int j=1; j<graph_size; j++) {
         for (int i=0; i<j; i++) {
             if (coin_dist(rng)) {
-                add_edge(vertices[i], vertices[j], g);
-                my_bit.set(--current_bit, true);
-            } else {
-                my_bit.set(--current_bit, false);
-            }
-            if (current_bit == 0) {
-                current_bit = 6;
-                int int_value = (int) my_bit.to_ulong();
-                g6string.push_back((char) (63 + int_value));
+                add_graph_edge(vertices[i], vertices[j]);
             }
         }
     }
-    if (current_bit != 6) {
-        while (current_bit > 0) {
-            my_bit.set(--current_bit, false);
+    graph_name = get_name();
+}
+
+/**
+ * Creates a random graph of order n without a Hamilton path, as initial graph of the EA for orders where random
+ * graphs are traceable. A random set S of (n - 2) / 2 vertices is chosen, and its complement I is independent; every
+ * edge inside S and between S and I is included with probability prob, and vertices of I without neighbour get a
+ * random one in S. Removing S leaves |I| >= |S| + 2 components, so no Hamilton path exists. The graph need not be
+ * connected.
+ */
+EvolutionGraph EvolutionGraph::nontraceable(int size, double prob, unsigned int seed) {
+    if (size < 4) {
+        throw std::invalid_argument("Orders below 4 are not supported");
+    }
+    EvolutionGraph graph(size, 0, seed);
+    std::mt19937 rng(seed);
+    std::vector<Vertex> order(graph.vertices);
+    std::shuffle(order.begin(), order.end(), rng);
+    std::size_t cut_size = (size - 2) / 2;
+    std::bernoulli_distribution coin_dist{prob};
+    std::uniform_int_distribution<std::size_t> pick_cut_vertex(0, cut_size - 1);
+    for (std::size_t j = 1; j < order.size(); j++) {
+        bool neighbour = false;
+        for (std::size_t i = 0; i < std::min(j, cut_size); i++) {
+            if (coin_dist(rng)) {
+                graph.add_graph_edge(order[i], order[j]);
+                neighbour = true;
+            }
+        }
+        if (j >= cut_size and not neighbour) {
+            graph.add_graph_edge(order[pick_cut_vertex(rng)], order[j]);
         }
-        g6string.push_back((char) (63 + my_bit.to_ulong()));
     }
-    g6string.push_back((char) (63 + my_bit.to_ulong()));
-    graph_name = g6string;
-
+    graph.graph_name = graph.get_name();
+    return graph;
 }
 
  /**
   * This function is used to calculate the toughness in the evolutionary algorithm.
-  * @param subset_pairs contains the sets used to calculate the toughness
+  * @param subset_pairs contains the sets used to calculate the toughness, empty above max_scanned_order
+  * @param subset_masks contains the same sets as bitmasks, used when this order has kernels (may be empty otherwise)
   * @param tough_required is the minimum toughness to test that determines when to break the algorithm
   * @param previous_cut is a useful cut of the parent graph
   * @param edge_addition is a boolean indicating whether an edge is added or removed
-  * @return
+  * @return the toughness and the cut attaining it
   */
 std::pair<double,std::vector<bool>> EvolutionGraph::solve_mutation(
-        const subset_pairs_t &subset_pairs, double tough_required, std::vector<bool> previous_cut, bool edge_addition) {
-    std::vector<bool> in_subgraph;
-    in_subgraph.resize(graph_size, true);
+        const subset_pairs_t &subset_pairs, const subset_masks_t &subset_masks, double tough_required,
+        const std::vector<bool> &previous_cut, bool edge_addition) {
+    if (not wide_adjacency.empty()) {
+        return solve_mutation_wide(tough_required, previous_cut, edge_addition);
+    }
+    // only needed without kernels
+    std::vector<bool> in_subgraph(kernels ? 0 : graph_size, true);
     Filtered f(g, keep_all{}, [&](Vertex v) { return in_subgraph[v]; });
 
 //    std::unordered_map<int, std::vector<std::vector<bool>>> current_sets;
@@ -73,82 +99,220 @@ std::pair<double,std::vector<bool>> EvolutionGraph::solve_mutation(
     size_t pair2 = graph_size-1;
     double tough = 100; //arbitrary large number
     std::vector<bool> best_cut;
+    mask_t best_alive = 0;  // the best cut, as a bitmask while the kernels are used
+    auto result = [&] {
+        if (kernels and tough < no_cut_toughness) {
+            to_subset(best_alive, graph_size, best_cut);
+        }
+        return make_pair(tough, std::move(best_cut));
+    };
 
-     /**
-      *  Lambda function that calculates the toughness based on the cuts provided in arr,
-      *   set_size contains the size of the cuts in arr
-      */
-     auto get_toughness = [&] (const std::vector<std::vector<bool>> &arr, const int set_size) {
-         std::vector<int> component(graph_size);
-         double tough = 100;
-//    double new_tough;
-         for (auto &row : arr) {  //loop over |S|
-             // update in_subgraph, which changes the filtered graph f
-             in_subgraph = row;
-             int comp_count = connected_components(f, &component[0]);
+    /**
+     *  Lambda function that updates tough and best_cut based on the cuts provided in arr,
+     *   set_size contains the size of the cuts in arr
+     *   returns whether tough dropped below tough_required
+     */
+    auto get_toughness = [&] (const std::vector<std::vector<bool>> &arr, const int set_size) {
+        if (kernels) {
+            mask_t pairs = mask_t(1) << pair1 | mask_t(1) << pair2;
+            for (auto &row : arr) {
+                mask_t alive = to_mask(row);
+                double new_tough = kernels->toughness(adjacency.data(), alive, pairs);
+                if (new_tough < tough) {
+                    tough = new_tough;
+                    best_alive = alive;
+                }
+                if (tough < tough_required) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        std::vector<int> component(graph_size);
+        for (auto &row : arr) {  //loop over |S|
+            // update in_subgraph, which changes the filtered graph f
+            in_subgraph = row;
+            int comp_count = connected_components(f, &component[0]);
 
-             // Subtract 1 for each component containing pair1 or pair2.
-             if (in_subgraph[pair1]) {
-                 if (in_subgraph[pair2]) {
-                     if (component[pair1] == component[pair2]) {
-                         comp_count--;
-                     } else {
-                         comp_count -= 2;
-                     }
-                 } else {
-                     comp_count--;
-                 }
-             } else if (in_subgraph[pair2]) {
-                 comp_count--;
-             }
+            // Subtract 1 for each component containing pair1 or pair2.
+            if (in_subgraph[pair1]) {
+                if (in_subgraph[pair2]) {
+                    if (component[pair1] == component[pair2]) {
+                        comp_count--;
+                    } else {
+                        comp_count -= 2;
+                    }
+                } else {
+                    comp_count--;
+                }
+            } else if (in_subgraph[pair2]) {
+                comp_count--;
+            }
+
+            if (comp_count > 0) {
+                // (2*|S| + 1) / (2 omega')
+                double new_tough = (2 * (graph_size - (double) set_size) + 1) / (2.0 * comp_count);
+                if (new_tough < tough) {
+                    tough = new_tough;
+                    best_cut = row;
+                }
+                if (tough < tough_required) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
 
-             if (comp_count > 0) {
-                 // (2*|S| + 1) / (2 omega')
-                 double new_tough = (2 * (graph_size - (double) set_size) + 1) / (2.0 * comp_count);
-                 if (new_tough < tough) {
-                     tough = new_tough;
-                     best_cut = row;
-                 }
-                 if (tough < tough_required) {
-                     return tough;
-                 }
-             }
-         }
-         return tough;
-     };
+    /**
+     *  The same as get_toughness, for cuts given as bitmasks. The cuts are evaluated in batches and then processed
+     *  in order, such that the result is the same as when evaluating one cut at a time.
+     */
+    auto get_toughness_masks = [&] (const std::vector<mask_t> &arr, const int set_size) {
+        int components[max_cut_batch];
+        unsigned char flags[max_cut_batch];
+        for (size_t offset = 0; offset < arr.size(); offset += max_cut_batch) {
+            size_t count = std::min(max_cut_batch, arr.size() - offset);
+            count_components_batch(adjacency.data(), graph_size, &arr[offset], count, pair1, pair2, components,
+                                   flags);
+            for (size_t c = 0; c < count; c++) {
+                int comp_count = omega_prime(components[c], flags[c]);
+                if (comp_count > 0) {
+                    double new_tough = (2 * (graph_size - (double) set_size) + 1) / (2.0 * comp_count);
+                    if (new_tough < tough) {
+                        tough = new_tough;
+                        best_alive = arr[offset + c];
+                    }
+                    if (tough < tough_required) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    };
+
+    /**
+     *  The same as get_toughness_masks, visiting all cuts of size graph_size - set_size in revolving door order
+     *  instead of table order, with the components updated incrementally.
+     */
+    auto get_toughness_gray = [&] (GrayCodeCuts &gray_cuts, const int set_size) {
+        return gray_cuts.for_each(set_size, [&] (mask_t alive, const GrayCodeCuts &cuts) {
+            int comp_count = cuts.omega_prime(pair1, pair2);
+            if (comp_count > 0) {
+                double new_tough = (2 * (graph_size - (double) set_size) + 1) / (2.0 * comp_count);
+                if (new_tough < tough) {
+                    tough = new_tough;
+                    best_alive = alive;
+                }
+                return tough < tough_required;
+            }
+            return false;
+        });
+    };
 
     //Check the previous solution
-    std::vector<std::vector<bool>> solution_wrapper;
-    solution_wrapper.push_back(previous_cut);
-    int previous_cut_size =  std::count(previous_cut.begin(), previous_cut.end(), true);
-    tough = std::min(tough, get_toughness(solution_wrapper, previous_cut_size));
-    if (tough < tough_required) {
-        return make_pair(tough, best_cut);
+    if (not previous_cut.empty() and kernels) {
+        // as a mask, without copying the cut into a table
+        mask_t alive = to_mask(previous_cut);
+        double new_tough = kernels->toughness(adjacency.data(), alive, mask_t(1) << pair1 | mask_t(1) << pair2);
+        if (new_tough < tough) {
+            tough = new_tough;
+            best_alive = alive;
+        }
+        if (tough < tough_required) {
+            return result();
+        }
+    } else if (not previous_cut.empty()) {
+        int previous_cut_size = std::count(previous_cut.begin(), previous_cut.end(), true);
+        if (get_toughness({previous_cut}, previous_cut_size)) {
+            return result();
+        }
     }
 
     //Only check hamilton path if a new edge is added, not when the mutation deletes one.
     if (edge_addition and exists_hamilton_path(pair1, pair2)) {
-        return make_pair(0, in_subgraph);
+        return make_pair(0.0, std::vector<bool>(graph_size, true));
     }
 
-    std::vector<bool> recent_cut;
-    double new_tough;
+    if (kernels and get_cut_order() == gray_cut_order) {
+        GrayCodeCuts gray_cuts(adjacency.data(), graph_size);
+        for (const auto &kv: subset_masks) {
+            if (get_toughness_gray(gray_cuts, kv.first)) {
+                return result();
+            }
+        }
+    } else if (kernels) {
+        for (const auto &kv: subset_masks) {
+            if (get_toughness_masks(kv.second, kv.first)) {
+                return result();
+            }
+        }
+    } else {
+        for (const auto &kv: subset_pairs) {
+            if (get_toughness(kv.second, kv.first)) {
+                return result();
+            }
+        }
+    }
 
+    return result();
+}
 
-    for (const auto &kv: subset_pairs) {
-        new_tough = get_toughness(kv.second, kv.first);
-        if (new_tough < tough) {
-            tough = new_tough;
-            best_cut = recent_cut;
+
+/**
+ * The same as solve_mutation, for the orders above max_scanned_order: the subset tables of these orders are too large
+ * to scan, so the cuts are found by the local search of wide::search_cut instead, and the result is an upper bound of
+ * the toughness. The Hamilton path search is limited as well (see wide::hamilton_path): a search that spends its
+ * budget proves nothing, so the graph then counts as traceable (toughness 0) unless a cut proves it is not (see
+ * wide::proves_nontraceable). The cuts are therefore searched before the path.
+ */
+std::pair<double,std::vector<bool>> EvolutionGraph::solve_mutation_wide(
+        double tough_required, const std::vector<bool> &previous_cut, bool edge_addition) {
+    size_t pair1 = 0;
+    size_t pair2 = graph_size-1;
+    wide_mask_t pairs;
+    pairs.set(pair1);
+    pairs.set(pair2);
+    double tough = no_cut_toughness;
+    wide_mask_t best_alive;
+    std::vector<bool> best_cut;
+    auto result = [&] {
+        if (tough < no_cut_toughness) {
+            wide::to_subset(best_alive, graph_size, best_cut);
         }
+        return make_pair(tough, std::move(best_cut));
+    };
+
+    //Check the previous solution
+    if (not previous_cut.empty()) {
+        best_alive = wide::to_mask(previous_cut);
+        tough = wide::toughness(wide_adjacency.data(), graph_size, best_alive, pairs);
         if (tough < tough_required) {
-            return make_pair(tough, best_cut);
+            return result();
         }
     }
 
-    return make_pair(tough, best_cut);
-}
+    wide_mask_t alive;
+    // the previous cut is a good start, since a mutation changes only one edge
+    double new_tough = wide::search_cut(wide_adjacency.data(), graph_size, pair1, pair2, tough_required,
+                                        best_alive, alive);
+    bool certified = wide::proves_nontraceable(wide_adjacency.data(), graph_size, best_alive) or
+                     wide::proves_nontraceable(wide_adjacency.data(), graph_size, alive);
+    if (new_tough < tough) {
+        tough = new_tough;
+        best_alive = alive;
+    }
+    if (tough < tough_required) {
+        return result();
+    }
 
+    //Only check hamilton path if a new edge is added, not when the mutation deletes one.
+    if (edge_addition and not certified and exists_hamilton_path(pair1, pair2)) {
+        return make_pair(0.0, std::vector<bool>(graph_size, true));
+    }
+    return result();
+}
 
 /**
  * This function perform a random mutation. Fifty per cent chance to add an edge such that each possible edge is equally
@@ -165,7 +329,7 @@ mutation_t EvolutionGraph::mutate(std::mt19937 &rng) {
             Vertex x = pick_vertex(rng);
             Vertex y = pick_vertex(rng);
             if (x != y and not edge(x, y, g).second) {
-                add_edge(x, y, g);
+                add_graph_edge(x, y);
                 // True means an edge is added
                 mutation = {true, x, y};
                 break;
@@ -177,7 +341,7 @@ mutation_t EvolutionGraph::mutate(std::mt19937 &rng) {
             Vertex x = pick_vertex(rng);
             Vertex y = pick_vertex(rng);
             if (x != y and edge(x, y, g).second) {
-                remove_edge(x, y, g);
+                remove_graph_edge(x, y);
                 // False means an edge is deleted
                 mutation = {false, x, y};
                 break;
@@ -193,9 +357,9 @@ mutation_t EvolutionGraph::mutate(std::mt19937 &rng) {
  */
 void EvolutionGraph::perform_mutation(mutation_t &mutation) {
     if (mutation.addition) {
-        add_edge(mutation.vertex1, mutation.vertex2, g);
+        add_graph_edge(mutation.vertex1, mutation.vertex2);
     } else {  //restore edge
-        remove_edge(mutation.vertex1, mutation.vertex2, g);
+        remove_graph_edge(mutation.vertex1, mutation.vertex2);
     }
 }
 
@@ -205,9 +369,9 @@ void EvolutionGraph::perform_mutation(mutation_t &mutation) {
  */
 void EvolutionGraph::undo_mutation(mutation_t &mutation) {
     if (mutation.addition) { //undo edge addition
-        remove_edge(mutation.vertex1, mutation.vertex2, g);
+        remove_graph_edge(mutation.vertex1, mutation.vertex2);
     } else {  //restore edge
-        add_edge(mutation.vertex1, mutation.vertex2, g);
+        add_graph_edge(mutation.vertex1, mutation.vertex2);
     }
 }
 
@@ -228,7 +392,8 @@ void EvolutionGraph::print_mutation(mutation_t &mutation) {
  * @return graph6 string representing graph
  */
 std::string EvolutionGraph::get_name() {
-    std::string g6string(1, (char) graph_size + 63);
+    std::string g6string;
+    append_graph6_order(graph_size, g6string);
     std::bitset<6> my_bit;
     size_t current_bit = 6;
     for (int j=1; j<graph_size; j++) {
@@ -255,6 +420,12 @@ std::string EvolutionGraph::get_name() {
  * @return the number of components
  */
 int EvolutionGraph::get_number_of_components() {
+    if (kernels) {
+        return kernels->count_components(adjacency.data(), kernels::full_mask(graph_size), 0);
+    }
+    if (not wide_adjacency.empty()) {
+        return wide::count_components(wide_adjacency.data(), wide::full_mask(graph_size), wide_mask_t());
+    }
     std::vector<int> component(graph_size);
     return connected_components(g, &component[0]);
 }
\ No newline at end of file
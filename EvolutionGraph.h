@@ -10,15 +10,25 @@ struct mutation_t {
     Vertex vertex2;
 };
 
+// The highest order whose subset tables the EA scans; these have 2^n cuts, so the orders above search their cuts
+// instead (see EvolutionGraph::solve_mutation_wide) and start from EvolutionGraph::nontraceable
+constexpr unsigned int max_scanned_order = 12;
+
 using subset_pairs_t = std::vector<std::pair<int, std::vector<std::vector<bool>>>>;
+using subset_masks_t = std::vector<std::pair<int, std::vector<mask_t>>>;
 
 class EvolutionGraph : public Graph {
-
+    std::pair<double,std::vector<bool>> solve_mutation_wide(double tough_required,
+                                                            const std::vector<bool> &previous_cut,
+                                                            bool edge_addition);
 public:
     EvolutionGraph();
-    EvolutionGraph(int size, double prob);
-    std::pair<double,std::vector<bool>> solve_mutation(const subset_pairs_t &subset_pairs, double tough_required,
-                                                       std::vector<bool> previous_cut, bool edge_addition= true);
+    EvolutionGraph(int size, double prob, unsigned int seed=std::random_device{}());
+    static EvolutionGraph nontraceable(int size, double prob, unsigned int seed=std::random_device{}());
+    std::pair<double,std::vector<bool>> solve_mutation(const subset_pairs_t &subset_pairs,
+                                                       const subset_masks_t &subset_masks, double tough_required,
+                                                       const std::vector<bool> &previous_cut,
+                                                       bool edge_addition= true);
     mutation_t mutate(std::mt19937 &rng);
     void perform_mutation(mutation_t &mutation);
     void undo_mutation(mutation_t &mutation);
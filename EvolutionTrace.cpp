@@ -0,0 +1,94 @@
+#include "EvolutionTrace.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+const char trace_magic[8] = {'T', 'N', 'H', 'T', 'R', 'A', 'C', '1'};
+
+}
+
+/**
+ * @param capacity the number of steps kept, the earlier steps are overwritten (32 bytes per step, allocated as steps
+ *        are recorded)
+ */
+EvolutionTrace::EvolutionTrace(std::size_t capacity) : capacity(capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("The capacity of a trace must be positive");
+    }
+    std::memcpy(header.magic, trace_magic, sizeof(trace_magic));
+    start_time = std::chrono::steady_clock::now();
+}
+
+EvolutionTrace::~EvolutionTrace() {
+    if (not dump_file.empty()) {
+        dump(dump_file);
+    }
+}
+
+/**
+ * Starts the trace of a run, discarding the steps recorded before.
+ */
+void EvolutionTrace::start(unsigned int order, unsigned int seed, double initial_toughness) {
+    recorded = 0;
+    records.clear();
+    header.order = order;
+    header.seed = seed;
+    header.initial_toughness = initial_toughness;
+    start_time = std::chrono::steady_clock::now();
+}
+
+/**
+ * Appends the run to the trace file: a trace_header followed by the kept records, oldest first.
+ * @return whether the file could be written
+ */
+bool EvolutionTrace::dump(const std::string &filename) const {
+    std::ofstream out(filename, std::ios::binary | std::ios::app);
+    if (!out) {
+        std::cerr << "The trace file " << filename << " cannot be opened" << std::endl;
+        return false;
+    }
+    trace_header run_header = header;
+    run_header.recorded = recorded;
+    run_header.count = (std::uint32_t) std::min<std::uint64_t>(recorded, capacity);
+    out.write(reinterpret_cast<const char *>(&run_header), sizeof(run_header));
+    std::size_t first = recorded > capacity ? recorded % capacity : 0;
+    for (std::size_t i = 0; i < run_header.count; i++) {
+        out.write(reinterpret_cast<const char *>(&records[(first + i) % capacity]), sizeof(trace_record));
+    }
+    return bool(out);
+}
+
+/**
+ * Writes the runs of a trace file as CSV, one line per step. Every run starts with a line for the initial graph
+ * (iteration -1), and a run of which earlier steps were overwritten continues at the first kept step.
+ * @return whether the input was a complete trace file
+ */
+bool decode_trace(std::istream &in, std::ostream &out) {
+    out << "run,order,seed,iteration,mutation,vertex1,vertex2,toughness,seconds,dropped" << std::endl;
+    out << std::setprecision(9);
+    trace_header header;
+    trace_record entry;
+    for (unsigned int run = 0; in.read(reinterpret_cast<char *>(&header), sizeof(header)); run++) {
+        if (std::memcmp(header.magic, trace_magic, sizeof(trace_magic)) != 0) {
+            std::cerr << "Not a trace file" << std::endl;
+            return false;
+        }
+        std::uint64_t dropped = header.recorded - header.count;
+        out << run << "," << header.order << "," << header.seed << ",-1,initial,,," << header.initial_toughness
+            << ",0," << dropped << "\n";
+        for (std::uint32_t i = 0; i < header.count; i++) {
+            if (not in.read(reinterpret_cast<char *>(&entry), sizeof(entry))) {
+                std::cerr << "The trace of run " << run << " is incomplete" << std::endl;
+                return false;
+            }
+            out << run << "," << header.order << "," << header.seed << "," << entry.iteration << ","
+                << (entry.addition ? "added" : "deleted") << "," << entry.vertex1 << "," << entry.vertex2 << ","
+                << entry.toughness << "," << entry.nanoseconds * 1e-9 << "," << dropped << "\n";
+        }
+    }
+    return in.eof() and in.gcount() == 0;
+}
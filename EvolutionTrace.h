@@ -0,0 +1,91 @@
+#ifndef REFACTORED_THESIS_EVOLUTIONTRACE_H
+#define REFACTORED_THESIS_EVOLUTIONTRACE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "EvolutionGraph.h"
+
+/**
+ * One accepted step of the evolutionary algorithm: the mutation that was performed and the toughness after it.
+ */
+struct trace_record {
+    std::uint64_t nanoseconds;  // since the start of the run
+    double toughness;
+    std::int32_t iteration;
+    std::uint32_t vertex1;
+    std::uint32_t vertex2;
+    std::uint8_t addition;      // 1 if the edge was added, 0 if it was removed
+    std::uint8_t reserved[3];
+};
+
+// trace files hold the records and headers as they are in memory
+static_assert(sizeof(trace_record) == 32, "the trace file format needs 32 byte records");
+
+/**
+ * Precedes the records of a run in a trace file, which holds the runs in the order they were dumped.
+ */
+struct trace_header {
+    char magic[8];
+    std::uint32_t order;
+    std::uint32_t seed;
+    double initial_toughness;
+    std::uint64_t recorded;     // the steps recorded during the run
+    std::uint32_t count;        // the records that follow: the last ones, at most the capacity of the trace
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(trace_header) == 40, "the trace file format needs 40 byte headers");
+
+constexpr std::size_t default_trace_capacity = 1 << 16;
+
+/**
+ * The convergence trace of a run of the evolutionary algorithm: the accepted steps, in a ring buffer that keeps the last
+ * capacity ones. The buffer grows with the steps recorded up to the capacity, so a run with few accepted steps (as most
+ * runs of main.cpp) needs little memory. Recording a step stores a record in memory and reads the clock, nothing is
+ * written and only the growth of the buffer allocates, so tracing does not change the timing of a run.
+ * dump appends the run to a binary trace file, which decode_trace turns into CSV (see the trace_decode target). If a
+ * dump file is set, the trace is dumped there when it is destroyed, i.e. at the end of the run.
+ */
+class EvolutionTrace {
+    std::vector<trace_record> records;
+    std::size_t capacity;
+    std::uint64_t recorded = 0;
+    trace_header header{};
+    std::chrono::steady_clock::time_point start_time;
+    std::string dump_file;
+public:
+    explicit EvolutionTrace(std::size_t capacity=default_trace_capacity);
+    EvolutionTrace(const EvolutionTrace &) = delete;
+    EvolutionTrace &operator=(const EvolutionTrace &) = delete;
+    ~EvolutionTrace();
+    void start(unsigned int order, unsigned int seed, double initial_toughness);
+    void set_dump_file(const std::string &filename) { dump_file = filename; }
+    std::uint64_t size() const { return recorded; }
+
+    void record(int iteration, const mutation_t &mutation, double toughness) {
+        if (records.size() < capacity) {
+            records.emplace_back();
+        }
+        trace_record &entry = records[recorded++ % capacity];
+        entry.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_time).count();
+        entry.toughness = toughness;
+        entry.iteration = iteration;
+        entry.vertex1 = mutation.vertex1;
+        entry.vertex2 = mutation.vertex2;
+        entry.addition = mutation.addition;
+        // an overwritten record keeps the bytes of the earlier one, and dump writes the whole record
+        entry.reserved[0] = entry.reserved[1] = entry.reserved[2] = 0;
+    }
+    bool dump(const std::string &filename) const;
+};
+
+bool decode_trace(std::istream &in, std::ostream &out);
+
+
+#endif //REFACTORED_THESIS_EVOLUTIONTRACE_H
@@ -1,30 +1,21 @@
 #include "EvolutionaryAlgorithm.h"
 #include <random>
 #include <iostream>
+#include <limits>
 #include <boost/graph/copy.hpp>
 #include "EnumerationAlgorithm.h"
 
 /**
- * The constructor automatically performs the evolutionary algorithm by calling evolve.
+ * The constructor automatically performs the evolutionary algorithm by calling evolve, printing the initial and the
+ * final graph with their toughness.
  * @param graph_size desired order of the graph; must be larger than 0
  * @param iterations desired number of iterations; must be larger than 0
+ * @param trace_file if not empty, the trace of the run is appended to this file at the end of the run
  */
-EvolutionaryAlgorithm::EvolutionaryAlgorithm(int graph_size, int iterations) {
+EvolutionaryAlgorithm::EvolutionaryAlgorithm(int graph_size, int iterations, const std::string &trace_file) {
     if (graph_size > 0 and iterations > 0) {
-        // seed the random number generator
-        std::random_device dev;
-        rng.seed(dev());
-        // Generate graphs until nonzero fitness is obtained
-        while (true) {
-            graph = EvolutionGraph(graph_size, 0.5);
-            if (graph.get_number_of_components() == 1 and not graph.exists_hamilton_path(0, graph_size - 1)) {
-                break;
-            }
-        }
-        for (size_t i = 2; i < graph_size; i++) {
-            subsets.emplace_back(i, EnumerationAlgorithm::get_sets(graph_size, i));
-        }
-        std::tie(current_tough, cut_S) = graph.solve_mutation(subsets, 0, cut_S);
+        trace.set_dump_file(trace_file);
+        initialise(graph_size, std::random_device{}());
         std::cout << graph.get_name() << "," << current_tough << ",";
         evolve(iterations);
     } else {
@@ -33,11 +24,95 @@ EvolutionaryAlgorithm::EvolutionaryAlgorithm(int graph_size, int iterations) {
 }
 
 /**
- * This function performs the evolutionary algorithm.
+ * Performs the evolutionary algorithm like the constructor, but returns the result instead of printing it.
+ * @param seed seeds the initial graph and the mutations, such that a run can be repeated
+ * @param target_toughness stops the run once reached; 0 for the default, 2.25 for n <= 11 and none otherwise
+ * @param trace_file if not empty, the trace of the run is appended to this file
+ */
+evolution_result EvolutionaryAlgorithm::evolve_graph(int graph_size, int iterations, unsigned int seed,
+                                                     double target_toughness, const std::string &trace_file) {
+    if (graph_size <= 0 or iterations <= 0) {
+        throw std::invalid_argument("graph size and iterations must be positive");
+    }
+    EvolutionaryAlgorithm algorithm;
+    algorithm.trace.set_dump_file(trace_file);
+    algorithm.initialise(graph_size, seed);
+    if (target_toughness > 0) {
+        algorithm.target_tough = target_toughness;
+    }
+    evolution_result result;
+    result.initial_graph = algorithm.graph.get_name();
+    result.initial_toughness = algorithm.current_tough;
+    result.final_iteration = algorithm.run(iterations);
+    result.graph = algorithm.graph.get_name();
+    result.toughness = algorithm.current_tough;
+    result.evaluations = algorithm.evaluations;
+    result.final_evaluation = algorithm.final_evaluation;
+    return result;
+}
+
+/**
+ * Draws a random connected graph without a Hamilton path between the vertices 0 and graph_size - 1, such that its
+ * fitness is nonzero. Above max_scanned_order random graphs are nearly always traceable, so a connected graph is drawn
+ * from EvolutionGraph::nontraceable instead.
+ */
+EvolutionGraph EvolutionaryAlgorithm::initial_graph(int graph_size, std::mt19937 &rng) {
+    if (graph_size > int(max_scanned_order)) {
+        while (true) {
+            EvolutionGraph graph = EvolutionGraph::nontraceable(graph_size, 0.5, rng());
+            if (graph.get_number_of_components() == 1) {
+                return graph;
+            }
+        }
+    }
+    // Generate graphs until nonzero fitness is obtained
+    while (true) {
+        EvolutionGraph graph(graph_size, 0.5, rng());
+        if (graph.get_number_of_components() == 1 and not graph.exists_hamilton_path(0, graph_size - 1)) {
+            return graph;
+        }
+    }
+}
+
+/**
+ * Seeds the random number generator, draws the initial graph (see initial_graph), computes its toughness and starts
+ * the trace.
+ */
+void EvolutionaryAlgorithm::initialise(int graph_size, unsigned int seed) {
+    rng.seed(seed);
+    graph = initial_graph(graph_size, rng);
+    // the larger orders search their cuts instead (see EvolutionGraph::solve_mutation_wide)
+    if (graph_size <= int(max_scanned_order)) {
+        subsets = EnumerationAlgorithm::get_subset_table(graph_size, EnumerationAlgorithm::all_sizes_table);
+        subset_masks = EnumerationAlgorithm::get_set_masks(subsets);
+    }
+    std::tie(current_tough, cut_S) = graph.solve_mutation(subsets, subset_masks, 0, cut_S);
+    evaluations = 1;
+    final_evaluation = 1;
+    // The result that 2.25 is best for n <= 11 follows form our enumeration algorithm
+    target_tough = graph_size <= 11 ? 2.25 : std::numeric_limits<double>::infinity();
+    generation = 0;
+    trace.start(graph_size, seed, current_tough);
+}
+
+/**
+ * This function performs the evolutionary algorithm and prints the final graph with its toughness and the iteration
+ * in which that toughness was reached.
  * @param iterations: number of iterations of the run
  * @return the final toughness
  */
 double EvolutionaryAlgorithm::evolve(int iterations) {
+    int final_counter = run(iterations);
+    std::string new_name = graph.get_name();
+    std::cout << new_name << "," << current_tough << "," << final_counter << std::endl;
+    return current_tough;
+}
+
+/**
+ * Performs the iterations of the evolutionary algorithm.
+ * @return the iteration in which the final toughness was reached
+ */
+int EvolutionaryAlgorithm::run(int iterations) {
     double old_tough = current_tough;
     int final_counter = 0;
     for (int i=0; i < iterations; i++) {
@@ -45,15 +120,13 @@ double EvolutionaryAlgorithm::evolve(int iterations) {
         if (changed and current_tough > old_tough) {
             old_tough = current_tough;
             final_counter = i;
+            final_evaluation = evaluations;
         }
-        // The result that 2.25 is best for n <= 11 follows form our enumeration algorithm
-        if (graph.graph_size <= 11 and current_tough >= 2.25) {
+        if (current_tough >= target_tough) {
             break;
         }
     }
-    std::string new_name = graph.get_name();
-    std::cout << new_name << "," << current_tough << "," << final_counter << std::endl;
-    return current_tough;
+    return final_counter;
 }
 
 /**
@@ -71,11 +144,12 @@ bool EvolutionaryAlgorithm::nextGen() {
         std::vector<bool> new_cut;
 
         std::tie(new_tough, new_cut) = graph.solve_mutation(
-                subsets, current_tough, cut_S, mutation.addition);
+                subsets, subset_masks, current_tough, cut_S, mutation.addition);
+        evaluations++;
         if (new_tough >= current_tough) {
             if (new_tough > best_tough) {
                 if (new_tough > current_tough) {
-                    cut_S = new_cut;
+                    cut_S = std::move(new_cut);
                 }
                 best_tough = new_tough;
                 best_mutation = mutation;
@@ -87,10 +161,9 @@ bool EvolutionaryAlgorithm::nextGen() {
     if (changed) {
         graph.perform_mutation(best_mutation);
         current_tough = best_tough;
-        // Uncomment following line for trace of the algorithm
-//        graph.print_mutation(best_mutation);
-
+        trace.record(generation, best_mutation, current_tough);
     }
+    generation++;
     return changed;
 }
 
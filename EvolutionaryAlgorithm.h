@@ -2,16 +2,46 @@
 #define THESIS_SINGLESURVIVOR_H
 
 #include "EvolutionGraph.h"
+#include "EvolutionTrace.h"
 #include <random>
 
+/**
+ * The outcome of a run of the evolutionary algorithm: the initial and the final graph (graph6) with their toughness
+ * (the fitness), the iteration in which the final toughness was reached, and the number of evaluations
+ * (solve_mutation calls) in total and until the final toughness was reached.
+ */
+struct evolution_result {
+    std::string initial_graph;
+    double initial_toughness;
+    std::string graph;
+    double toughness;
+    int final_iteration;
+    long evaluations;
+    long final_evaluation;
+};
+
 class EvolutionaryAlgorithm {
     std::mt19937 rng;
     std::vector<bool> cut_S;
+    long evaluations = 0;
+    long final_evaluation = 0;
+    double target_tough{};  // the run stops once this toughness is reached
+    int generation = 0;
+
+    EvolutionaryAlgorithm() = default;
+    void initialise(int graph_size, unsigned int seed);
+    int run(int iterations);
 public:
     EvolutionGraph graph;
     std::vector<std::pair<int, std::vector<std::vector<bool>>>> subsets;
+    std::vector<std::pair<int, std::vector<mask_t>>> subset_masks;
     double current_tough{};
-    explicit EvolutionaryAlgorithm(int graph_size, int iterations);
+    // the accepted steps of the run
+    EvolutionTrace trace;
+    explicit EvolutionaryAlgorithm(int graph_size, int iterations, const std::string &trace_file="");
+    static EvolutionGraph initial_graph(int graph_size, std::mt19937 &rng);
+    static evolution_result evolve_graph(int graph_size, int iterations, unsigned int seed=std::random_device{}(),
+                                         double target_toughness=0, const std::string &trace_file="");
     double evolve(int iterations);
     bool nextGen();
 };
@@ -11,12 +11,69 @@
 Graph::Graph() = default;
 
 
+/**
+ * Selects the kernels specialised for graph_size, if any, and sizes the bitmask adjacency accordingly. The orders from
+ * min_wide_order up to max_wide_order get the multi-word bitmask adjacency of the wide functions instead, also where
+ * kernels exist; their searches are not exhaustive, so the enumeration keeps the default and the Boost Graph Library
+ * code above the kernels.
+ * The vertices must not have any edges yet.
+ */
+void Graph::select_kernels(unsigned int min_wide_order) {
+    bool wide = graph_size >= min_wide_order and graph_size <= max_wide_order;
+    kernels = wide ? nullptr : find_kernels(graph_size);
+    adjacency.assign(kernels ? graph_size : 0, 0);
+    wide_adjacency.assign(wide ? graph_size : 0, wide_mask_t());
+}
+
+/**
+ * Adds an edge to both the boost graph and the bitmask adjacency.
+ */
+void Graph::add_graph_edge(Vertex u, Vertex v) {
+    if (boost_edges) {
+        add_edge(u, v, g);
+    }
+    if (kernels) {
+        adjacency[u] |= mask_t(1) << v;
+        adjacency[v] |= mask_t(1) << u;
+    } else if (not wide_adjacency.empty()) {
+        wide_adjacency[u].set(v);
+        wide_adjacency[v].set(u);
+    }
+}
+
+/**
+ * Removes an edge from both the boost graph and the bitmask adjacency.
+ */
+void Graph::remove_graph_edge(Vertex u, Vertex v) {
+    if (boost_edges) {
+        remove_edge(u, v, g);
+    }
+    if (kernels) {
+        adjacency[u] &= ~(mask_t(1) << v);
+        adjacency[v] &= ~(mask_t(1) << u);
+    } else if (not wide_adjacency.empty()) {
+        wide_adjacency[u].reset(v);
+        wide_adjacency[v].reset(u);
+    }
+}
+
+
 /**
  * This function exports a graph to the dot format and saves it in a file for visualisation.
  */
 void Graph::write_dot(const std::string &filename) {
     std::ofstream dot_file(filename);
-    write_graphviz(dot_file, g);
+    if (boost_edges) {
+        write_graphviz(dot_file, g);
+        return;
+    }
+    graph_t edges(graph_size);
+    for (size_t j = 1; j < graph_size; j++) {
+        for (mask_t lower = adjacency[j] & ((mask_t(1) << j) - 1); lower; lower &= lower - 1) {
+            add_edge(j, kernels::lowest(lower), edges);
+        }
+    }
+    write_graphviz(dot_file, edges);
 }
 
 /**
@@ -25,6 +82,20 @@ void Graph::write_dot(const std::string &filename) {
  * @return
  */
 int Graph::hasCompleteClosure(int k_closure) {
+    if (kernels) {
+        std::array<mask_t, max_kernel_order> original;
+        std::copy(adjacency.begin(), adjacency.end(), original.begin());
+        bool complete = kernels->complete_closure(adjacency.data(), k_closure);
+        // keep the boost graph in sync with the closure
+        for (size_t i = 0; boost_edges and i < graph_size; i++) {
+            mask_t new_neighbours = adjacency[i] & ~original[i] & ~((mask_t(2) << i) - 1);
+            while (new_neighbours) {
+                add_edge(vertices[i], vertices[kernels::lowest(new_neighbours)], g);
+                new_neighbours &= new_neighbours - 1;
+            }
+        }
+        return complete;
+    }
     std::vector<int> degrees;
     degrees.reserve(graph_size);
     for (size_t i=0; i<graph_size; i++) {
@@ -78,7 +149,7 @@ int Graph::hasCompleteClosure(int k_closure) {
             }
         }
         // add edge and update degrees
-        add_edge(vertices[new_edges[i].first], vertices[new_edges[i].second], g);
+        add_graph_edge(vertices[new_edges[i].first], vertices[new_edges[i].second]);
         degrees[new_edges[i].first]++;
         degrees[new_edges[i].second]++;
     }
@@ -110,9 +181,31 @@ bool Graph::exists_hamilton_path_helper(Vertex from, Vertex to, Path &path) {
     return false;
 }
 
+/**
+ * Searches a Hamilton path between the vertices from and to, using the kernel of this order if there is one.
+ * The path is stored in path when it is found. Above the kernel orders the search is limited (see wide), so a path
+ * may exist even if none is found; exists_hamilton_path answers conservatively for these orders.
+ */
+bool Graph::find_hamilton_path(Vertex from, Vertex to, Path &path) {
+    if (kernels) {
+        return kernels->hamilton_path(adjacency.data(), from, to, path);
+    }
+    if (not wide_adjacency.empty()) {
+        return wide::hamilton_path(wide_adjacency.data(), graph_size, from, to, path) == wide::hamilton_found;
+    }
+    return exists_hamilton_path_helper(from, to, path);
+}
+
+/**
+ * Whether there is a Hamilton path between the vertices from and to. Above the kernel orders a search that spends its
+ * budget counts as a path, since it cannot rule one out.
+ */
 bool Graph::exists_hamilton_path(Vertex from, Vertex to) {
     Path path;
-    return exists_hamilton_path_helper(from, to, path);
+    if (not wide_adjacency.empty()) {
+        return wide::hamilton_path(wide_adjacency.data(), graph_size, from, to, path) != wide::hamilton_none;
+    }
+    return find_hamilton_path(from, to, path);
 }
 
 
@@ -122,7 +215,23 @@ bool Graph::exists_hamilton_path(Vertex from, Vertex to) {
  * It is assumed it has the correct length.
  */
 // This is not so efficient on dense graphs, edge has O(n),
-bool Graph::check_hamilton_path(Path &path) {
+bool Graph::check_hamilton_path(const Path &path) {
+    if (kernels) {
+        for (size_t i = 0; i < graph_size - 1; i++) {
+            if (not(adjacency[path[i]] >> path[i + 1] & 1)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (not wide_adjacency.empty()) {
+        for (size_t i = 0; i < graph_size - 1; i++) {
+            if (not wide_adjacency[path[i]][path[i + 1]]) {
+                return false;
+            }
+        }
+        return true;
+    }
     for (size_t i = 0; i < graph_size - 1; i++ ) {
         if (not edge(path[i], path[i+1], g).second) {
             return false;
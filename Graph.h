@@ -5,6 +5,8 @@
 #include <boost/graph/filtered_graph.hpp>
 #include <boost/function.hpp>
 #include <random>
+#include "GraphKernels.h"
+#include "WideKernels.h"
 
 //https://www.boost.org/doc/libs/1_65_0/libs/graph/doc/using_adjacency_list.html
 //out_edge_iterator::operator++() This operation is constant time for all the OneD types.
@@ -20,10 +22,21 @@ using Filtered = filtered_graph<graph_t, keep_all, boost::function<bool(Vertex)>
 class Graph {
 protected:
     std::vector<Vertex> vertices;
-    bool check_hamilton_path(Path &path);
+    bool check_hamilton_path(const Path &path);
     bool exists_hamilton_path_helper(Vertex from, Vertex to, Path &path);
+    bool find_hamilton_path(Vertex from, Vertex to, Path &path);
     std::string graph_name;
     graph_t g;
+    // Order specialised kernels and the bitmask adjacency they work on, nullptr/empty for unsupported orders
+    const graph_kernels *kernels = nullptr;
+    std::vector<mask_t> adjacency;
+    // The multi-word bitmask adjacency of the orders that select it (up to max_wide_order), empty otherwise
+    std::vector<wide_mask_t> wide_adjacency;
+    // Whether g holds the edges too; if not (only with kernels) g only has the vertices, see write_dot
+    bool boost_edges = true;
+    void select_kernels(unsigned int min_wide_order=max_wide_order + 1);
+    void add_graph_edge(Vertex u, Vertex v);
+    void remove_graph_edge(Vertex u, Vertex v);
 public:
     Graph();
     unsigned int graph_size{};
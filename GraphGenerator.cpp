@@ -0,0 +1,322 @@
+#include "GraphGenerator.h"
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace {
+
+constexpr unsigned int max_order = 32;
+using table_t = std::array<mask_t, max_order>;
+
+/**
+ * An ordered partition of the vertices, each cell a bitmask. The position of a cell determines the labels of its
+ * vertices, so all operations only depend on cell positions and counts, never on vertex numbers.
+ */
+struct partition_t {
+    table_t cells;
+    unsigned int count;
+};
+
+/**
+ * The search tree of canonical_labelling. Nodes are equitable partitions, children individualise a vertex of the
+ * first non-singleton cell, and the leaves (discrete partitions) are labellings. The canonical form is the largest
+ * relabelled adjacency table over all leaves. Subtrees are skipped when an automorphism found so far maps them to an
+ * explored one: children in the orbit of an explored child (under the automorphisms fixing the current path), and
+ * the remainder of a subtree whose leaf turned out to be equivalent to the first or best leaf.
+ */
+struct canonical_search {
+    const mask_t *adjacency;
+    unsigned int order;
+    bool have_leaf = false;
+    table_t first_certificate, best_certificate;
+    std::array<unsigned int, max_order> first_labelling, best_labelling;
+    std::array<unsigned int, max_order> first_path, best_path, path{};
+    std::vector<std::array<unsigned char, max_order>> automorphisms;
+
+    /**
+     * Refines the partition until it is equitable: every cell is split by the number of neighbours its vertices have
+     * in the splitters, and every new cell becomes a splitter as well.
+     */
+    void refine(partition_t &partition, mask_t splitter) const {
+        std::array<mask_t, 4 * max_order> queue;
+        std::size_t head = 0;
+        std::size_t tail = 0;
+        queue[tail++] = splitter;
+        while (head < tail) {
+            mask_t w = queue[head++];
+            for (unsigned int x = 0; x < partition.count; x++) {
+                mask_t cell = partition.cells[x];
+                if ((cell & (cell - 1)) == 0) {
+                    continue;
+                }
+                std::array<mask_t, max_order + 1> buckets{};
+                unsigned long long used = 0;
+                for (mask_t rest = cell; rest; rest &= rest - 1) {
+                    unsigned int v = kernels::lowest(rest);
+                    unsigned int c = __builtin_popcount(adjacency[v] & w);
+                    buckets[c] |= mask_t(1) << v;
+                    used |= 1ull << c;
+                }
+                unsigned int parts = __builtin_popcountll(used);
+                if (parts == 1) {
+                    continue;
+                }
+                std::copy_backward(partition.cells.begin() + x + 1, partition.cells.begin() + partition.count,
+                                   partition.cells.begin() + partition.count + parts - 1);
+                unsigned int position = x;
+                for (; used; used &= used - 1) {
+                    mask_t part = buckets[__builtin_ctzll(used)];
+                    partition.cells[position++] = part;
+                    if (tail < queue.size()) {
+                        queue[tail++] = part;
+                    }
+                }
+                partition.count += parts - 1;
+                x += parts - 1;
+            }
+        }
+    }
+
+    void leaf(const partition_t &partition, table_t &certificate, std::array<unsigned int, max_order> &labelling) const {
+        std::array<unsigned int, max_order> position;
+        for (unsigned int i = 0; i < order; i++) {
+            labelling[i] = kernels::lowest(partition.cells[i]);
+            position[labelling[i]] = i;
+        }
+        for (unsigned int i = 0; i < order; i++) {
+            mask_t row = 0;
+            for (mask_t rest = adjacency[labelling[i]]; rest; rest &= rest - 1) {
+                row |= mask_t(1) << position[kernels::lowest(rest)];
+            }
+            certificate[i] = row;
+        }
+    }
+
+    int compare(const table_t &a, const table_t &b) const {
+        for (unsigned int i = 0; i < order; i++) {
+            if (a[i] != b[i]) {
+                return a[i] < b[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * Stores the automorphism mapping the leaf with labelling from to the leaf with labelling to.
+     * @return the depth of the deepest common ancestor of both leaves, where the search continues
+     */
+    int add_automorphism(const std::array<unsigned int, max_order> &from,
+                         const std::array<unsigned int, max_order> &from_path,
+                         const std::array<unsigned int, max_order> &to, unsigned int depth) {
+        std::array<unsigned char, max_order> automorphism;
+        for (unsigned int i = 0; i < order; i++) {
+            automorphism[from[i]] = (unsigned char) to[i];
+        }
+        automorphisms.push_back(automorphism);
+        unsigned int common = 0;
+        while (common < depth and from_path[common] == path[common]) {
+            common++;
+        }
+        return int(common);
+    }
+
+    /**
+     * @return the orbit of v under the automorphisms found so far that fix the first depth vertices of path
+     */
+    mask_t orbit(unsigned int v, unsigned int depth) const {
+        mask_t result = mask_t(1) << v;
+        mask_t previous = 0;
+        while (result != previous) {
+            previous = result;
+            for (const auto &automorphism : automorphisms) {
+                bool fixes_path = true;
+                for (unsigned int i = 0; i < depth and fixes_path; i++) {
+                    fixes_path = automorphism[path[i]] == path[i];
+                }
+                if (not fixes_path) {
+                    continue;
+                }
+                for (mask_t rest = result; rest; rest &= rest - 1) {
+                    result |= mask_t(1) << automorphism[kernels::lowest(rest)];
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @return INT_MAX, or the depth to return to when the rest of this subtree is equivalent to an explored one
+     */
+    int search(const partition_t &partition, unsigned int depth) {
+        if (partition.count == order) {
+            table_t certificate;
+            std::array<unsigned int, max_order> labelling;
+            leaf(partition, certificate, labelling);
+            if (not have_leaf) {
+                have_leaf = true;
+                first_certificate = best_certificate = certificate;
+                first_labelling = best_labelling = labelling;
+                first_path = best_path = path;
+                return INT_MAX;
+            }
+            if (compare(certificate, first_certificate) == 0) {
+                return add_automorphism(first_labelling, first_path, labelling, depth);
+            }
+            int comparison = compare(certificate, best_certificate);
+            if (comparison == 0) {
+                return add_automorphism(best_labelling, best_path, labelling, depth);
+            }
+            if (comparison > 0) {
+                best_certificate = certificate;
+                best_labelling = labelling;
+                best_path = path;
+            }
+            return INT_MAX;
+        }
+        unsigned int target = 0;
+        while ((partition.cells[target] & (partition.cells[target] - 1)) == 0) {
+            target++;
+        }
+        mask_t explored = 0;
+        for (mask_t rest = partition.cells[target]; rest; rest &= rest - 1) {
+            unsigned int v = kernels::lowest(rest);
+            if (orbit(v, depth) & explored) {
+                continue;
+            }
+            explored |= mask_t(1) << v;
+            partition_t child;
+            std::copy(partition.cells.begin(), partition.cells.begin() + target, child.cells.begin());
+            child.cells[target] = mask_t(1) << v;
+            child.cells[target + 1] = partition.cells[target] & ~(mask_t(1) << v);
+            std::copy(partition.cells.begin() + target + 1, partition.cells.begin() + partition.count,
+                      child.cells.begin() + target + 2);
+            child.count = partition.count + 1;
+            refine(child, mask_t(1) << v);
+            path[depth] = v;
+            int result = search(child, depth + 1);
+            if (result < int(depth)) {
+                return result;
+            }
+        }
+        return INT_MAX;
+    }
+};
+
+}
+
+void canonical_labelling(const mask_t *adjacency, unsigned int order, mask_t *canonical, unsigned int *labelling) {
+    canonical_search search;
+    search.adjacency = adjacency;
+    search.order = order;
+    partition_t root;
+    root.cells[0] = kernels::full_mask(order);
+    root.count = 1;
+    search.refine(root, root.cells[0]);
+    search.search(root, 0);
+    std::copy(search.best_certificate.begin(), search.best_certificate.begin() + order, canonical);
+    std::copy(search.best_labelling.begin(), search.best_labelling.begin() + order, labelling);
+}
+
+
+GraphGenerator::GraphGenerator(unsigned int order, unsigned int min_degree, int k_closure, unsigned int res,
+                               unsigned int mod) :
+        order(order), min_degree(min_degree), k_closure(k_closure), res(res), mod(mod) {
+    if (order < min_kernel_order or order > max_kernel_order) {
+        throw std::invalid_argument("The generator supports orders 5 to 24");
+    }
+    if (mod == 0 or res >= mod) {
+        throw std::invalid_argument("res must be smaller than mod");
+    }
+    kernels = find_kernels(order);
+    // a level with enough classes to balance the parts, like the splitting level of geng
+    split_level = order > 5 ? order - 3 : order;
+}
+
+/**
+ * Calls visitor with the canonical adjacency table of every generated graph.
+ */
+void GraphGenerator::generate(const std::function<void(const mask_t *)> &visitor) {
+    visit = visitor;
+    split_counter = 0;
+    table_t single_vertex{};
+    extend(single_vertex, 1);
+}
+
+/**
+ * Generates all children of the canonically labelled graph parent on size vertices, and recurses on them.
+ */
+void GraphGenerator::extend(const table_t &parent, unsigned int size) {
+    const unsigned int child_size = size + 1;
+    const unsigned int remaining = order - child_size;  // vertices still to be added after this level
+    std::unordered_set<std::string> children;
+    table_t child, canonical, reduced, reduced_canonical;
+    std::array<unsigned int, max_order> labelling, reduced_labelling;
+    std::array<int, max_order> degrees;
+
+    for (mask_t neighbours = 0; neighbours < (mask_t(1) << size); neighbours++) {
+        int new_degree = __builtin_popcount(neighbours);
+        if (new_degree + remaining < min_degree) {
+            continue;
+        }
+        // the new vertex has to be the canonical deletion vertex, which has minimum degree
+        bool possible = true;
+        int lowest_degree = new_degree;
+        for (unsigned int v = 0; v < size and possible; v++) {
+            child[v] = parent[v] | (neighbours >> v & 1) << size;
+            degrees[v] = __builtin_popcount(child[v]);
+            lowest_degree = std::min(lowest_degree, degrees[v]);
+            possible = degrees[v] + remaining >= min_degree and degrees[v] >= new_degree;
+        }
+        if (not possible) {
+            continue;
+        }
+        child[size] = neighbours;
+        degrees[size] = new_degree;
+
+        if (child_size == order) {
+            if (kernels->count_components(child.data(), kernels::full_mask(order), 0) != 1) {
+                continue;
+            }
+            if (k_closure > 0) {
+                table_t closure = child;
+                if (kernels->complete_closure(closure.data(), k_closure)) {
+                    continue;
+                }
+            }
+        }
+
+        canonical_labelling(child.data(), child_size, canonical.data(), labelling.data());
+        // canonical deletion vertex: the minimum degree vertex with the largest canonical label
+        unsigned int label = child_size - 1;
+        while (degrees[labelling[label]] != lowest_degree) {
+            label--;
+        }
+        unsigned int deletion_vertex = labelling[label];
+        if (deletion_vertex != size) {
+            // accept only if deleting the canonical deletion vertex gives the parent back
+            for (unsigned int v = 0, r = 0; v < child_size; v++) {
+                if (v != deletion_vertex) {
+                    mask_t row = child[v] & ~(mask_t(1) << deletion_vertex);
+                    mask_t low = row & ((mask_t(1) << deletion_vertex) - 1);
+                    reduced[r++] = low | (row >> 1 & ~((mask_t(1) << deletion_vertex) - 1));
+                }
+            }
+            canonical_labelling(reduced.data(), size, reduced_canonical.data(), reduced_labelling.data());
+            if (not std::equal(parent.begin(), parent.begin() + size, reduced_canonical.begin())) {
+                continue;
+            }
+        }
+        if (not children.emplace((const char *) canonical.data(), child_size * sizeof(mask_t)).second) {
+            continue;
+        }
+        if (child_size == split_level and split_counter++ % mod != res) {
+            continue;
+        }
+        if (child_size == order) {
+            visit(canonical.data());
+        } else {
+            extend(canonical, child_size);
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef REFACTORED_THESIS_GRAPHGENERATOR_H
+#define REFACTORED_THESIS_GRAPHGENERATOR_H
+
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+#include "GraphKernels.h"
+
+/**
+ * Generates the connected graphs of a given order, one per isomorphism class, by canonical augmentation (McKay,
+ * "Isomorph-free exhaustive generation", 1998): a graph is extended by a new vertex with every possible neighbourhood,
+ * and an extension is accepted only if the new vertex is a canonical choice of vertex to delete again, i.e. deleting
+ * the canonical deletion vertex gives back the parent (up to isomorphism). Isomorphic extensions of the same parent
+ * are removed by comparing canonical forms.
+ *
+ * Graphs are pruned during generation when a vertex cannot reach min_degree anymore, and at the last level
+ * disconnected graphs and (if k_closure > 0) graphs with a complete k-closure are discarded before canonical
+ * labelling. Every graph is handed to the visitor as a canonically labelled adjacency table, no files are involved.
+ *
+ * The classes at split_level are numbered in generation order; only those with number % mod == res are extended,
+ * such that mod independent runs with res = 0, ..., mod-1 together generate every graph exactly once.
+ */
+class GraphGenerator {
+    unsigned int order;
+    unsigned int min_degree;
+    int k_closure;
+    unsigned int res;
+    unsigned int mod;
+    unsigned int split_level;
+    unsigned long split_counter = 0;
+    const graph_kernels *kernels;
+    std::function<void(const mask_t *)> visit;
+
+    void extend(const std::array<mask_t, 32> &parent, unsigned int size);
+public:
+    GraphGenerator(unsigned int order, unsigned int min_degree=1, int k_closure=0, unsigned int res=0,
+                   unsigned int mod=1);
+    void generate(const std::function<void(const mask_t *)> &visitor);
+};
+
+/**
+ * Canonical labelling by individualisation and refinement, for graphs up to 32 vertices.
+ * labelling[i] is the vertex that gets label i, canonical[i] the neighbourhood of vertex i after relabelling; the
+ * canonical adjacency tables of two graphs are equal if and only if the graphs are isomorphic.
+ */
+void canonical_labelling(const mask_t *adjacency, unsigned int order, mask_t *canonical, unsigned int *labelling);
+
+
+#endif //REFACTORED_THESIS_GRAPHGENERATOR_H
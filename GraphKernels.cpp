@@ -0,0 +1,125 @@
+#include "GraphKernels.h"
+#include <stdexcept>
+
+namespace {
+
+template<unsigned int N>
+constexpr graph_kernels make_kernels() {
+    return {N, &kernels::decode_graph6<N>, &kernels::complete_closure<N>, &kernels::count_components<N>,
+            &kernels::hamilton_path<N>, &kernels::toughness<N>};
+}
+
+template<std::size_t... I>
+constexpr std::array<graph_kernels, sizeof...(I)> make_kernel_table(std::index_sequence<I...>) {
+    return {{make_kernels<min_kernel_order + I>()...}};
+}
+
+// One instantiation per order, indexed by order - min_kernel_order
+const std::array<graph_kernels, max_kernel_order - min_kernel_order + 1> kernel_table =
+        make_kernel_table(std::make_index_sequence<max_kernel_order - min_kernel_order + 1>{});
+
+}
+
+const graph_kernels *find_kernels(unsigned int order) {
+    if (order < min_kernel_order or order > max_kernel_order) {
+        return nullptr;
+    }
+    return &kernel_table[order - min_kernel_order];
+}
+
+/**
+ * Converts a subset in the std::vector<bool> representation used by the subset tables to a bitmask.
+ */
+mask_t to_mask(const std::vector<bool> &subset) {
+    mask_t mask = 0;
+    for (size_t i = 0; i < subset.size(); i++) {
+        if (subset[i]) {
+            mask |= mask_t(1) << i;
+        }
+    }
+    return mask;
+}
+
+/**
+ * Converts a bitmask back to the std::vector<bool> representation of a subset of {0, 1, ..., order-1}.
+ */
+std::vector<bool> to_subset(mask_t mask, unsigned int order) {
+    std::vector<bool> subset;
+    to_subset(mask, order, subset);
+    return subset;
+}
+
+/**
+ * The same as above, writing into subset, which does not allocate if subset already had order elements.
+ */
+void to_subset(mask_t mask, unsigned int order, std::vector<bool> &subset) {
+    subset.resize(order);
+    for (unsigned int i = 0; i < order; i++) {
+        subset[i] = mask >> i & 1;
+    }
+}
+
+/**
+ * Encodes an adjacency table as graph6 (orders below 63), the inverse of decode_graph6 including the size byte.
+ */
+std::string to_graph6(const mask_t *adjacency, unsigned int order) {
+    std::string graph6;
+    to_graph6(adjacency, order, graph6);
+    return graph6;
+}
+
+/**
+ * The same as above, writing into graph6, which does not allocate if its capacity suffices.
+ */
+void to_graph6(const mask_t *adjacency, unsigned int order, std::string &graph6) {
+    graph6.assign(1 + (order * (order - 1) / 2 + 5) / 6, 0);
+    graph6[0] = char(order);
+    unsigned int bit = 0;
+    for (unsigned int outer = 1; outer < order; outer++) {
+        for (unsigned int inner = 0; inner < outer; inner++, bit++) {
+            // bits are stored from the most significant of the six bits of each character
+            graph6[1 + bit / 6] = char(graph6[1 + bit / 6] | (adjacency[outer] >> inner & 1) << (5 - bit % 6));
+        }
+    }
+    for (char &c : graph6) {
+        c = char(c + 63);
+    }
+}
+
+/**
+ * Reads the order of a graph6 string: a single byte for orders below 63, or the long form ~ followed by three bytes
+ * of six bits for orders up to 258047.
+ * @param body receives the index of the first byte after the order
+ */
+unsigned int graph6_order(const char *graph6, std::size_t length, std::size_t &body) {
+    if (length == 0) {
+        throw std::invalid_argument("Empty graph6 string");
+    }
+    if (graph6[0] != 126) {
+        body = 1;
+        return (unsigned int) (graph6[0] - 63);
+    }
+    if (length < 4 or graph6[1] == 126) {
+        throw std::invalid_argument("graph6 orders above 258047 are not supported");
+    }
+    body = 4;
+    unsigned int order = 0;
+    for (std::size_t i = 1; i < 4; i++) {
+        order = order << 6 | (unsigned int) (graph6[i] - 63);
+    }
+    return order;
+}
+
+/**
+ * Appends the order to a graph6 string, in the long form for orders of 63 and above.
+ */
+void append_graph6_order(unsigned int order, std::string &graph6) {
+    if (order < 63) {
+        graph6.push_back(char(order + 63));
+        return;
+    }
+    graph6.push_back(char(126));
+    graph6.push_back(char((order >> 12 & 63) + 63));
+    graph6.push_back(char((order >> 6 & 63) + 63));
+    graph6.push_back(char((order & 63) + 63));
+}
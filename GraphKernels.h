@@ -0,0 +1,195 @@
+#ifndef REFACTORED_THESIS_GRAPHKERNELS_H
+#define REFACTORED_THESIS_GRAPHKERNELS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Row i of an adjacency table holds the neighbourhood of vertex i as a bitmask, bit v set iff {i, v} is an edge.
+using mask_t = std::uint32_t;
+
+constexpr unsigned int min_kernel_order = 5;
+constexpr unsigned int max_kernel_order = 24;
+
+/**
+ * The graph kernels of a single order N. Every order in [min_kernel_order, max_kernel_order] has its own
+ * instantiation, such that the vertex count, the full vertex mask and the number of graph6 bytes are known at compile
+ * time. Use find_kernels to obtain the table of a given order.
+ */
+struct graph_kernels {
+    unsigned int order;
+    // decodes the graph6 body (the characters after the size byte) into an adjacency table
+    void (*decode_graph6)(const char *body, mask_t *adjacency);
+    // adds the edges of the k-closure to the adjacency table, returns whether the closure is complete
+    bool (*complete_closure)(mask_t *adjacency, int k_closure);
+    // number of components of the subgraph induced by alive that contain no vertex of pairs
+    int (*count_components)(const mask_t *adjacency, mask_t alive, mask_t pairs);
+    // depth first search for a Hamilton path from -> to, the path is written to path when found
+    bool (*hamilton_path)(const mask_t *adjacency, unsigned int from, unsigned int to, std::vector<std::size_t> &path);
+    // (2|S| + 1) / (2 omega') of the cut S = V \ alive, or no_cut_toughness if omega' = 0
+    double (*toughness)(const mask_t *adjacency, mask_t alive, mask_t pairs);
+};
+
+// Returned by the toughness kernel when a cut leaves no component without pair vertices (arbitrary large number)
+constexpr double no_cut_toughness = 100;
+
+/**
+ * @return the kernels of the given order, or nullptr if this order has no specialisation
+ */
+const graph_kernels *find_kernels(unsigned int order);
+
+mask_t to_mask(const std::vector<bool> &subset);
+std::vector<bool> to_subset(mask_t mask, unsigned int order);
+void to_subset(mask_t mask, unsigned int order, std::vector<bool> &subset);
+std::string to_graph6(const mask_t *adjacency, unsigned int order);
+void to_graph6(const mask_t *adjacency, unsigned int order, std::string &graph6);
+unsigned int graph6_order(const char *graph6, std::size_t length, std::size_t &body);
+void append_graph6_order(unsigned int order, std::string &graph6);
+
+
+namespace kernels {
+
+constexpr mask_t full_mask(unsigned int n) {
+    return n >= 32 ? ~mask_t(0) : (mask_t(1) << n) - 1;
+}
+
+inline unsigned int lowest(mask_t mask) {
+    return (unsigned int) __builtin_ctz(mask);
+}
+
+template<unsigned int N>
+void decode_graph6(const char *body, mask_t *adjacency) {
+    constexpr unsigned int bit_count = N * (N - 1) / 2;
+    for (unsigned int i = 0; i < N; i++) {
+        adjacency[i] = 0;
+    }
+    unsigned int outer = 1;
+    unsigned int inner = 0;
+    for (unsigned int bit = 0; bit < bit_count; bit++) {
+        // bits are stored from the most significant of the six bits of each character
+        if ((body[bit / 6] - 63) >> (5 - bit % 6) & 1) {
+            adjacency[outer] |= mask_t(1) << inner;
+            adjacency[inner] |= mask_t(1) << outer;
+        }
+        if (++inner == outer) {
+            outer++;
+            inner = 0;
+        }
+    }
+}
+
+/**
+ * The same closure as Graph::hasCompleteClosure. Each vertex whose degree changed is queued, and all its non-neighbours
+ * are tested against the closure condition once it is dequeued; every vertex is checked after its final degree change,
+ * so the fixed point is the (unique) closure.
+ */
+template<unsigned int N>
+bool complete_closure(mask_t *adjacency, int k_closure) {
+    constexpr mask_t full = full_mask(N);
+    std::array<int, N> degrees;
+    int d_sum = 0;
+    for (unsigned int i = 0; i < N; i++) {
+        degrees[i] = __builtin_popcount(adjacency[i]);
+        d_sum += degrees[i];
+    }
+    mask_t pending = full;
+    while (pending) {
+        unsigned int u = lowest(pending);
+        pending &= pending - 1;
+        mask_t candidates = ~adjacency[u] & full & ~(mask_t(1) << u);
+        bool changed = false;
+        while (candidates) {
+            unsigned int v = lowest(candidates);
+            candidates &= candidates - 1;
+            if (degrees[u] + degrees[v] >= k_closure) {
+                adjacency[u] |= mask_t(1) << v;
+                adjacency[v] |= mask_t(1) << u;
+                degrees[u]++;
+                degrees[v]++;
+                d_sum += 2;
+                pending |= mask_t(1) << v;
+                changed = true;
+            }
+        }
+        if (changed) {
+            // pairs of u rejected before its degree increased need another look
+            pending |= mask_t(1) << u;
+        }
+    }
+    return d_sum == int(N * (N - 1));
+}
+
+template<unsigned int N>
+int count_components(const mask_t *adjacency, mask_t alive, mask_t pairs) {
+    int comp_count = 0;
+    mask_t rest = alive & full_mask(N);
+    while (rest) {
+        mask_t component = rest & (~rest + 1);
+        mask_t frontier = component;
+        while (frontier) {
+            unsigned int v = lowest(frontier);
+            frontier &= frontier - 1;
+            mask_t reached = adjacency[v] & rest & ~component;
+            component |= reached;
+            frontier |= reached;
+        }
+        rest &= ~component;
+        if (not(component & pairs)) {
+            comp_count++;
+        }
+    }
+    return comp_count;
+}
+
+template<unsigned int N>
+bool hamilton_path(const mask_t *adjacency, unsigned int from, unsigned int to, std::vector<std::size_t> &path) {
+    if (from == to) {
+        return false;
+    }
+    const mask_t to_bit = mask_t(1) << to;
+    std::array<unsigned int, N> stack;
+    std::array<mask_t, N> options;
+    mask_t visited = mask_t(1) << from;
+    unsigned int depth = 0;
+    stack[0] = from;
+    // the target may only be entered as the final vertex of the path
+    options[0] = adjacency[from] & ~visited & (N == 2 ? to_bit : ~to_bit);
+    while (true) {
+        if (options[depth] == 0) {
+            if (depth == 0) {
+                return false;
+            }
+            visited &= ~(mask_t(1) << stack[depth]);
+            depth--;
+            continue;
+        }
+        unsigned int v = lowest(options[depth]);
+        options[depth] &= options[depth] - 1;
+        stack[++depth] = v;
+        visited |= mask_t(1) << v;
+        if (depth == N - 1) {
+            break;
+        }
+        options[depth] = adjacency[v] & ~visited & (depth + 2 == N ? to_bit : ~to_bit);
+    }
+    path.assign(stack.begin(), stack.end());
+    return true;
+}
+
+template<unsigned int N>
+double toughness(const mask_t *adjacency, mask_t alive, mask_t pairs) {
+    int comp_count = count_components<N>(adjacency, alive, pairs);
+    if (comp_count > 0) {
+        int cut_size = int(N) - __builtin_popcount(alive);
+        return (2.0 * cut_size + 1) / (2.0 * comp_count);
+    }
+    return no_cut_toughness;
+}
+
+} // namespace kernels
+
+
+#endif //REFACTORED_THESIS_GRAPHKERNELS_H
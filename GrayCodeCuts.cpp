@@ -0,0 +1,26 @@
+#include "GrayCodeCuts.h"
+#include <atomic>
+
+namespace {
+
+// Atomic, as the solver threads read it while it may be set
+std::atomic<cut_order_t> selected_cut_order{table_cut_order};
+
+}
+
+void set_cut_order(cut_order_t order) {
+    selected_cut_order = order;
+}
+
+cut_order_t get_cut_order() {
+    return selected_cut_order;
+}
+
+void RollbackUnionFind::reset(unsigned int order) {
+    for (unsigned int v = 0; v < order; v++) {
+        parent[v] = v;
+        set_size[v] = 1;
+    }
+    history_size = 0;
+    components = 0;
+}
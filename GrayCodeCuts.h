@@ -0,0 +1,162 @@
+#ifndef REFACTORED_THESIS_GRAYCODECUTS_H
+#define REFACTORED_THESIS_GRAYCODECUTS_H
+
+#include <array>
+#include <utility>
+#include "GraphKernels.h"
+
+/**
+ * Union-find on the vertices of G - S that can undo its operations. Union by size without path compression keeps
+ * every operation reversible, finds take O(log n).
+ */
+class RollbackUnionFind {
+    static constexpr unsigned int max_order = 32;  // the width of mask_t
+    std::array<int, max_order> parent;
+    std::array<int, max_order> set_size;
+    // Performed operations: the root that was attached to another root, or ~v when vertex v was added.
+    // Each vertex is added and attached at most once, so 2 * max_order entries suffice.
+    std::array<int, 2 * max_order> history;
+    std::size_t history_size = 0;
+    int components = 0;
+public:
+    void reset(unsigned int order);
+    int find(int v) const {
+        while (parent[v] != v) {
+            v = parent[v];
+        }
+        return v;
+    }
+    void add_vertex(int v) {
+        history[history_size++] = ~v;
+        components++;
+    }
+    void unite(int u, int v) {
+        u = find(u);
+        v = find(v);
+        if (u == v) {
+            return;
+        }
+        if (set_size[u] < set_size[v]) {
+            std::swap(u, v);
+        }
+        parent[v] = u;
+        set_size[u] += set_size[v];
+        history[history_size++] = v;
+        components--;
+    }
+    int get_components() const { return components; }
+    std::size_t checkpoint() const { return history_size; }
+    /**
+     * Undoes all operations performed after the given checkpoint, in reverse order.
+     */
+    void rollback(std::size_t checkpoint) {
+        while (history_size > checkpoint) {
+            int v = history[--history_size];
+            if (v < 0) {
+                components--;
+            } else {
+                set_size[parent[v]] -= set_size[v];
+                parent[v] = v;
+                components++;
+            }
+        }
+    }
+};
+
+enum cut_order_t { table_cut_order, gray_cut_order };
+
+// Order in which the full scans of EnumerationGraph::solve and EvolutionGraph::solve_mutation visit the cuts.
+// table_cut_order (default) follows the subset tables, gray_cut_order uses GrayCodeCuts.
+void set_cut_order(cut_order_t order);
+cut_order_t get_cut_order();
+
+/**
+ * Enumerates all sets of keep vertices that remain after a cut (like the rows of the subset tables) in revolving door
+ * order: consecutive sets differ by swapping one vertex in and one vertex out. The components of G - S are maintained
+ * incrementally in a RollbackUnionFind; the enumeration is a walk over the binary tree deciding vertex 0, 1, ... in
+ * turn, so adding a vertex only unites it with its kept neighbours among the decided vertices, and leaving a subtree
+ * rolls those unions back.
+ */
+class GrayCodeCuts {
+    const mask_t *adjacency;
+    unsigned int order;
+    RollbackUnionFind union_find;
+    mask_t alive = 0;
+
+    void keep_vertex(unsigned int v) {
+        union_find.add_vertex(v);
+        mask_t neighbours = adjacency[v] & alive;
+        while (neighbours) {
+            union_find.unite(v, kernels::lowest(neighbours));
+            neighbours &= neighbours - 1;
+        }
+        alive |= mask_t(1) << v;
+    }
+
+    /**
+     * Visits the sets that keep exactly keep of the vertices first, ..., order-1 besides those in alive.
+     * In forward direction the sets without vertex first come first, followed by those with it in reverse order;
+     * in reverse direction everything is mirrored. This is the revolving door recursion on the reversed labels.
+     */
+    template<class Visitor>
+    bool walk(unsigned int first, unsigned int keep, bool reverse, Visitor &visit) {
+        if (keep == 0 or keep == order - first) {
+            std::size_t checkpoint = union_find.checkpoint();
+            mask_t before = alive;
+            for (unsigned int v = first; keep != 0 and v < order; v++) {
+                keep_vertex(v);
+            }
+            bool stop = visit(alive, (const GrayCodeCuts &) *this);
+            union_find.rollback(checkpoint);
+            alive = before;
+            return stop;
+        }
+        for (int branch = 0; branch < 2; branch++) {
+            if ((branch == 0) != reverse) {
+                if (walk(first + 1, keep, reverse, visit)) {
+                    return true;
+                }
+            } else {
+                std::size_t checkpoint = union_find.checkpoint();
+                keep_vertex(first);
+                bool stop = walk(first + 1, keep - 1, not reverse, visit);
+                union_find.rollback(checkpoint);
+                alive &= ~(mask_t(1) << first);
+                if (stop) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+public:
+    GrayCodeCuts(const mask_t *adjacency, unsigned int order) : adjacency(adjacency), order(order) {}
+
+    /**
+     * Calls visit(alive, cuts) for every set alive of keep vertices, in revolving door order, until it returns true.
+     * @return whether the enumeration was stopped by the visitor
+     */
+    template<class Visitor>
+    bool for_each(unsigned int keep, Visitor visit) {
+        union_find.reset(order);
+        alive = 0;
+        return walk(0, keep, false, visit);
+    }
+
+    /**
+     * @return the number of components of the current G - S that contain neither pair1 nor pair2
+     */
+    int omega_prime(unsigned int pair1, unsigned int pair2) const {
+        int comp_count = union_find.get_components();
+        bool alive1 = alive >> pair1 & 1;
+        bool alive2 = alive >> pair2 & 1;
+        if (alive1 and alive2 and union_find.find(pair1) == union_find.find(pair2)) {
+            return comp_count - 1;
+        }
+        return comp_count - alive1 - alive2;
+    }
+};
+
+
+#endif //REFACTORED_THESIS_GRAYCODECUTS_H
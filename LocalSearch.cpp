@@ -0,0 +1,122 @@
+#include "LocalSearch.h"
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "EnumerationAlgorithm.h"
+#include "EvolutionaryAlgorithm.h"
+
+namespace {
+
+// the tries to draw a mutation that is not tabu, after which a tabu one is taken
+constexpr int tabu_redraws = 32;
+
+}
+
+/**
+ * Draws the initial graph as EvolutionaryAlgorithm does and computes its toughness.
+ * @param graph_size desired order of the graph; must be larger than 2 and at most max_wide_order
+ */
+LocalSearch::LocalSearch(int graph_size, const search_options &options, unsigned int seed) : options(options) {
+    if (graph_size <= 2 or graph_size > int(max_wide_order) or options.candidates == 0) {
+        throw std::invalid_argument("graph size must lie in [3, " + std::to_string(max_wide_order) +
+                                    "] and candidates positive");
+    }
+    if (this->options.tabu_tenure == 0) {
+        this->options.tabu_tenure = graph_size;
+    }
+    rng.seed(seed);
+    graph = EvolutionaryAlgorithm::initial_graph(graph_size, rng);
+    if (graph_size <= int(max_scanned_order)) {
+        subsets = EnumerationAlgorithm::get_subset_table(graph_size, EnumerationAlgorithm::all_sizes_table);
+        subset_masks = EnumerationAlgorithm::get_set_masks(subsets);
+    }
+    std::tie(current_tough, cut_S) = graph.solve_mutation(subsets, subset_masks, 0, cut_S);
+    tabu_until.assign(graph_size * graph_size, 0);
+}
+
+std::size_t LocalSearch::edge_index(Vertex u, Vertex v) const {
+    return u < v ? u * graph.graph_size + v : v * graph.graph_size + u;
+}
+
+/**
+ * Performs a random mutation (see EvolutionGraph::mutate) of an edge that is not tabu in this step, if one is found
+ * within tabu_redraws tries.
+ */
+mutation_t LocalSearch::draw_mutation(long step) {
+    mutation_t mutation = graph.mutate(rng);
+    for (int i = 0; i < tabu_redraws and tabu_until[edge_index(mutation.vertex1, mutation.vertex2)] > step; i++) {
+        graph.undo_mutation(mutation);
+        mutation = graph.mutate(rng);
+    }
+    return mutation;
+}
+
+/**
+ * Performs the search until the target toughness is reached or the budget is spent.
+ */
+search_result LocalSearch::run() {
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&] {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+    search_result result{graph.get_name(), current_tough, graph.get_name(), current_tough, 1, 1, -1, 0};
+    if (current_tough >= options.target_toughness) {
+        result.target_evaluation = 1;
+    }
+    std::uniform_real_distribution<double> uniform(0, 1);
+    double temperature = options.initial_temperature;
+    for (long step = 0; result.target_evaluation < 0 and result.evaluations < options.max_evaluations; step++) {
+        if (options.max_seconds > 0 and elapsed() >= options.max_seconds) {
+            break;
+        }
+        // the annealing threshold of this step, kept above 0
+        double threshold = current_tough + temperature * std::log(1 - uniform(rng));
+        threshold = std::max(threshold, std::numeric_limits<double>::min());
+
+        bool accepted = false;
+        mutation_t best_mutation{};
+        double best_tough = 0;
+        std::vector<bool> best_cut;
+        for (unsigned int i = 0; i < options.candidates and result.evaluations < options.max_evaluations; i++) {
+            mutation_t mutation = draw_mutation(step);
+            double new_tough;
+            std::vector<bool> new_cut;
+            // candidates below the threshold or the best candidate so far are rejected, so their scan can stop early
+            std::tie(new_tough, new_cut) = graph.solve_mutation(
+                    subsets, subset_masks, std::max(threshold, best_tough), cut_S, mutation.addition);
+            result.evaluations++;
+            if (new_tough >= threshold and new_tough > best_tough) {
+                accepted = true;
+                best_mutation = mutation;
+                best_tough = new_tough;
+                best_cut = std::move(new_cut);
+            }
+            graph.undo_mutation(mutation);
+        }
+        if (accepted) {
+            graph.perform_mutation(best_mutation);
+            current_tough = best_tough;
+            cut_S = std::move(best_cut);
+            tabu_until[edge_index(best_mutation.vertex1, best_mutation.vertex2)] = step + 1 + options.tabu_tenure;
+            if (current_tough > result.best_toughness) {
+                result.best_toughness = current_tough;
+                result.best_graph = graph.get_name();
+                result.best_evaluation = result.evaluations;
+                if (current_tough >= options.target_toughness) {
+                    result.target_evaluation = result.evaluations;
+                }
+            }
+        }
+        temperature *= options.cooling;
+    }
+    result.seconds = elapsed();
+    return result;
+}
+
+/**
+ * Runs a search from a random initial graph of the given order.
+ */
+search_result LocalSearch::search(int graph_size, const search_options &options, unsigned int seed) {
+    return LocalSearch(graph_size, options, seed).run();
+}
@@ -0,0 +1,67 @@
+#ifndef REFACTORED_THESIS_LOCALSEARCH_H
+#define REFACTORED_THESIS_LOCALSEARCH_H
+
+#include <random>
+#include <string>
+#include <vector>
+#include "EvolutionGraph.h"
+
+struct search_options {
+    double target_toughness = 2.25;     // the search stops once the toughness reaches this value
+    long max_evaluations = 1000000;     // budget of solve_mutation calls
+    double max_seconds = 0;             // wall clock budget, 0 for none
+    unsigned int candidates = 4;        // mutations evaluated per step, the best acceptable one is taken
+    unsigned int tabu_tenure = 0;       // steps an edge flip stays tabu, 0 for the order of the graph
+    double initial_temperature = 0.15;  // of the annealing acceptance, in units of toughness
+    double cooling = 0.9995;            // the temperature is multiplied by this factor every step
+};
+
+/**
+ * The outcome of a search: the initial graph and the best graph found (graph6) with their toughness, the number of
+ * evaluations (solve_mutation calls) in total, until the best toughness was found and until the target toughness was
+ * reached (-1 if it was not), and the wall clock time.
+ */
+struct search_result {
+    std::string initial_graph;
+    double initial_toughness;
+    std::string best_graph;
+    double best_toughness;
+    long evaluations;
+    long best_evaluation;
+    long target_evaluation;
+    double seconds;
+};
+
+/**
+ * An alternative to the (1+4) hill climber of EvolutionaryAlgorithm, on the same mutate / solve_mutation /
+ * undo_mutation machinery and the same fitness (the toughness for the pair 0, n-1).
+ * Every step evaluates a number of candidate mutations and moves to the best one that is acceptable. A mutation is
+ * acceptable if its toughness is at least a threshold drawn per step as in simulated annealing, current toughness +
+ * temperature * ln(u) with u uniform on (0, 1], such that worse graphs are accepted with probability
+ * exp(-decrease / temperature). Since the threshold is known beforehand, solve_mutation still stops as soon as a cut
+ * below it is found. Graphs with a Hamilton path between the pair (toughness 0) are never accepted.
+ * An edge that was flipped is tabu for tabu_tenure steps: candidates flipping it are redrawn (up to a limit), which
+ * keeps the search from undoing its moves on plateaus.
+ */
+class LocalSearch {
+    search_options options;
+    std::mt19937 rng;
+    EvolutionGraph graph;
+    std::vector<std::pair<int, std::vector<std::vector<bool>>>> subsets;
+    std::vector<std::pair<int, std::vector<mask_t>>> subset_masks;
+    std::vector<bool> cut_S;
+    double current_tough{};
+    // per vertex pair, the step until which flipping its edge is tabu
+    std::vector<long> tabu_until;
+
+    std::size_t edge_index(Vertex u, Vertex v) const;
+    mutation_t draw_mutation(long step);
+public:
+    LocalSearch(int graph_size, const search_options &options, unsigned int seed=std::random_device{}());
+    search_result run();
+    static search_result search(int graph_size, const search_options &options={},
+                                unsigned int seed=std::random_device{}());
+};
+
+
+#endif //REFACTORED_THESIS_LOCALSEARCH_H
@@ -0,0 +1,283 @@
+#include "ResultStore.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char store_magic[8] = {'T', 'N', 'H', 'S', 'T', 'O', 'R', '2'};
+
+struct record_header {
+    std::uint64_t key_hash;
+    std::uint32_t record_size;  // including this header
+    std::uint16_t key_length;
+    std::uint8_t order;
+    std::uint8_t table;
+};
+
+// FNV-1a
+std::uint64_t hash_key(const std::string &graph6) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : graph6) {
+        hash = (hash ^ (unsigned char) c) * 1099511628211ull;
+    }
+    return hash;
+}
+
+std::size_t path_bytes(unsigned int order) {
+    return order <= 16 ? (order - 1) / 2 : order - 2;
+}
+
+std::size_t mask_bytes(unsigned int order) {
+    return (order + 7) / 8;
+}
+
+// the kind byte and the larger of a path and a cut, so a record can be overwritten in place
+std::size_t entry_bytes(unsigned int order) {
+    return 1 + std::max(path_bytes(order), 1 + mask_bytes(order));
+}
+
+std::size_t record_bytes(unsigned int order, std::size_t key_length) {
+    return sizeof(record_header) + key_length + order * (order - 1) / 2 * entry_bytes(order);
+}
+
+// the i-th inner vertex of a stored path
+unsigned int path_vertex(const unsigned char *data, unsigned int order, unsigned int i) {
+    return order <= 16 ? data[i / 2] >> (i % 2 * 4) & 15 : data[i];
+}
+
+void write_all(int file, const unsigned char *data, std::size_t size, std::size_t offset) {
+    while (size > 0) {
+        ssize_t written = ::pwrite(file, data, size, offset);
+        if (written < 0) {
+            throw std::runtime_error("Writing to the result store failed");
+        }
+        data += written;
+        size -= written;
+        offset += written;
+    }
+}
+
+}
+
+/**
+ * Opens the result store, creating it if the file does not exist. The file is cut off at the first record that is
+ * incomplete (e.g. because the process was killed) or corrupt.
+ */
+ResultStore::ResultStore(const std::string &filename) {
+    file = ::open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (file < 0) {
+        throw std::runtime_error("The result store " + filename + " cannot be opened");
+    }
+    struct stat status{};
+    fstat(file, &status);
+    file_size = status.st_size;
+    if (file_size == 0) {
+        write_all(file, (const unsigned char *) store_magic, sizeof(store_magic), 0);
+        file_size = sizeof(store_magic);
+    }
+    map_file();
+    if (std::memcmp(mapping, store_magic, sizeof(store_magic)) != 0) {
+        throw std::runtime_error(filename + " is not a result store");
+    }
+    std::size_t offset = sizeof(store_magic);
+    while (offset < file_size) {
+        std::size_t record_size = parse_record(offset);
+        if (record_size == 0) {
+            break;
+        }
+        record_header header{};
+        std::memcpy(&header, mapping + offset, sizeof(header));
+        auto key = (const char *) mapping + offset + sizeof(header);
+        if (find_record(header.key_hash, key, header.key_length, header.table) != index.end()) {
+            break;  // every key and table is stored once
+        }
+        index.emplace(header.key_hash, offset);
+        offset += record_size;
+    }
+    if (offset != file_size) {
+        if (ftruncate(file, offset) != 0) {
+            throw std::runtime_error("The result store " + filename + " cannot be repaired");
+        }
+        file_size = offset;
+    }
+}
+
+ResultStore::~ResultStore() {
+    if (mapping) {
+        munmap(mapping, mapped_size);
+    }
+    if (file >= 0) {
+        close(file);
+    }
+}
+
+/**
+ * (Re)maps the complete file. Appended records become visible to lookups only after remapping, records overwritten in
+ * place at once.
+ */
+void ResultStore::map_file() {
+    if (mapping) {
+        munmap(mapping, mapped_size);
+    }
+    mapping = (unsigned char *) mmap(nullptr, file_size, PROT_READ, MAP_SHARED, file, 0);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        throw std::runtime_error("The result store cannot be mapped");
+    }
+    mapped_size = file_size;
+}
+
+/**
+ * Checks the record at offset: its size must follow from its order and key length, and the vertices and masks of its
+ * entries must lie within its order.
+ * @return the size of the record at offset, or 0 if it is incomplete or corrupt
+ */
+std::size_t ResultStore::parse_record(std::size_t offset) const {
+    if (offset + sizeof(record_header) > mapped_size) {
+        return 0;
+    }
+    record_header header{};
+    std::memcpy(&header, mapping + offset, sizeof(header));
+    unsigned int order = header.order;
+    if (order < 2 or order > max_kernel_order or header.record_size != record_bytes(order, header.key_length) or
+            header.record_size > mapped_size - offset) {
+        return 0;
+    }
+    const unsigned char *data = mapping + offset + sizeof(header) + header.key_length;
+    for (unsigned int pair = 0; pair < order * (order - 1) / 2; pair++, data += entry_bytes(order)) {
+        unsigned char kind = data[0];
+        if (kind == stored_path) {
+            for (unsigned int i = 0; i + 2 < order; i++) {
+                if (path_vertex(data + 1, order, i) >= order) {
+                    return 0;
+                }
+            }
+        } else if (kind == stored_cut or kind == stored_open_cut) {
+            if (data[1] == 0 or (order % 8 != 0 and data[1 + mask_bytes(order)] >> (order % 8) != 0)) {
+                return 0;  // no component or vertices beyond the order
+            }
+        } else if (kind != stored_no_cut) {
+            return 0;
+        }
+    }
+    return header.record_size;
+}
+
+/**
+ * The index entry of the record of the given key and table, or index.end(). The keys of the records are compared, so
+ * keys with the same hash are told apart.
+ */
+std::unordered_multimap<std::uint64_t, std::size_t>::iterator ResultStore::find_record(
+        std::uint64_t key_hash, const char *key, std::size_t key_length, unsigned char table) {
+    auto range = index.equal_range(key_hash);
+    for (auto iterator = range.first; iterator != range.second; ++iterator) {
+        if (iterator->second >= mapped_size) {
+            map_file();  // appended after the last mapping
+        }
+        const unsigned char *record = mapping + iterator->second;
+        record_header header{};
+        std::memcpy(&header, record, sizeof(header));
+        if (header.table == table and header.key_length == key_length and
+                std::memcmp(record + sizeof(header), key, key_length) == 0) {
+            return iterator;
+        }
+    }
+    return index.end();
+}
+
+/**
+ * Looks up the results of a graph for the subset table.
+ * @return whether the graph is in the store
+ */
+bool ResultStore::lookup(const std::string &graph6, unsigned char table, stored_graph &result) {
+    auto iterator = find_record(hash_key(graph6), graph6.data(), graph6.size(), table);
+    if (iterator == index.end()) {
+        return false;
+    }
+    const unsigned char *record = mapping + iterator->second;
+    record_header header{};
+    std::memcpy(&header, record, sizeof(header));
+    const unsigned char *data = record + sizeof(header) + header.key_length;
+
+    unsigned int order = header.order;
+    result.order = order;
+    result.table = header.table;
+    result.pairs.resize(order * (order - 1) / 2);
+    std::size_t pair_index = 0;
+    for (unsigned int pair1 = 0; pair1 + 1 < order; pair1++) {
+        for (unsigned int pair2 = pair1 + 1; pair2 < order; pair2++) {
+            stored_pair &pair = result.pairs[pair_index++];
+            pair.kind = stored_kind(data[0]);
+            if (pair.kind == stored_path) {
+                pair.path.resize(order);
+                pair.path.front() = pair1;
+                pair.path.back() = pair2;
+                for (unsigned int i = 0; i + 2 < order; i++) {
+                    pair.path[i + 1] = path_vertex(data + 1, order, i);
+                }
+            } else if (pair.kind == stored_cut or pair.kind == stored_open_cut) {
+                pair.components = data[1];
+                pair.alive = 0;
+                for (std::size_t i = 0; i < mask_bytes(order); i++) {
+                    pair.alive |= mask_t(data[2 + i]) << (8 * i);
+                }
+            }
+            data += entry_bytes(order);
+        }
+    }
+    return true;
+}
+
+/**
+ * Stores the results of a graph. A graph that is already stored for the table is overwritten in place, so merging new
+ * results into a record does not grow the file.
+ */
+void ResultStore::put(const std::string &graph6, const stored_graph &result) {
+    unsigned int order = result.order;
+    if (order > max_kernel_order) {
+        throw std::invalid_argument("The result store supports graphs up to order 24");
+    }
+    std::vector<unsigned char> record(record_bytes(order, graph6.size()), 0);
+    record_header header{hash_key(graph6), (std::uint32_t) record.size(), (std::uint16_t) graph6.size(),
+                         (std::uint8_t) order, result.table};
+    std::memcpy(record.data(), &header, sizeof(header));
+    std::memcpy(record.data() + sizeof(header), graph6.data(), graph6.size());
+    unsigned char *data = record.data() + sizeof(header) + graph6.size();
+    for (const auto &pair : result.pairs) {
+        data[0] = pair.kind;
+        if (pair.kind == stored_path) {
+            for (unsigned int i = 0; i + 2 < order; i++) {
+                auto v = (unsigned char) pair.path[i + 1];
+                if (order <= 16) {
+                    data[1 + i / 2] |= v << (i % 2 * 4);
+                } else {
+                    data[1 + i] = v;
+                }
+            }
+        } else if (pair.kind == stored_cut or pair.kind == stored_open_cut) {
+            data[1] = (unsigned char) pair.components;
+            for (std::size_t i = 0; i < mask_bytes(order); i++) {
+                data[2 + i] = (unsigned char) (pair.alive >> (8 * i));
+            }
+        }
+        data += entry_bytes(order);
+    }
+
+    auto previous = find_record(header.key_hash, graph6.data(), graph6.size(), result.table);
+    if (previous != index.end()) {
+        std::size_t offset = previous->second;
+        if (record_bytes(mapping[offset + offsetof(record_header, order)], graph6.size()) != record.size()) {
+            throw std::invalid_argument("The stored graph " + graph6 + " has a different order");
+        }
+        write_all(file, record.data(), record.size(), offset);
+    } else {
+        write_all(file, record.data(), record.size(), file_size);
+        index.emplace(header.key_hash, file_size);
+        file_size += record.size();
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef REFACTORED_THESIS_RESULTSTORE_H
+#define REFACTORED_THESIS_RESULTSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "GraphKernels.h"
+
+enum stored_kind : unsigned char {
+    stored_path = 0,    // a Hamilton path between the pair was found
+    stored_cut = 1,     // there is no Hamilton path, the cut is one of lowest (2|S| + 1) / (2 omega') in the table
+    stored_no_cut = 2,  // neither: there is no Hamilton path and no cut of the table leaves a component (omega' = 0)
+    stored_open_cut = 3 // the cut is one of lowest ratio in the table, the pair was not searched for a Hamilton path
+};
+
+/**
+ * The result of one vertex pair, pairs are stored in the order (0,1), (0,2), ..., (1,2), ... of EnumerationGraph::solve
+ */
+struct stored_pair {
+    stored_kind kind;
+    std::vector<std::size_t> path;  // stored_path: the Hamilton path, from pair1 to pair2
+    mask_t alive = 0;               // stored_cut, stored_open_cut: the vertices not in the cut
+    int components = 0;             // stored_cut, stored_open_cut: omega', the components containing neither vertex
+};
+
+/**
+ * The results of a graph for one subset table. As the cuts are the ones of lowest ratio, they decide the pairs for
+ * every toughness_test, except for open cuts whose ratio is not below it.
+ */
+struct stored_graph {
+    unsigned int order;
+    unsigned char table;    // the subset table that was scanned, see EnumerationAlgorithm
+    std::vector<stored_pair> pairs;
+};
+
+/**
+ * A file of enumeration results, keyed by the graph6 string of the graph and the subset table. The file is memory
+ * mapped for lookups. New graphs are appended at the end, a graph that is stored again for the same table is
+ * overwritten in place, as its record has the same size. Graphs with more than max_kernel_order vertices cannot be
+ * stored. The file uses the byte order of the machine and must not be written by several processes at once.
+ *
+ * Layout: an 8 byte magic, followed by records of a header (hash, record size, key length, order and table), the
+ * graph6 key and one entry per pair. An entry is the kind byte followed by the inner vertices of the path (nibbles if
+ * order <= 16, bytes otherwise) or by omega' and the bytes of the alive mask of a cut, padded to the larger of both.
+ */
+class ResultStore {
+    int file = -1;
+    unsigned char *mapping = nullptr;
+    std::size_t mapped_size = 0;
+    std::size_t file_size = 0;
+    // offsets of the record of each key and table, by key hash; keys with the same hash share a bucket
+    std::unordered_multimap<std::uint64_t, std::size_t> index;
+
+    void map_file();
+    std::size_t parse_record(std::size_t offset) const;
+    std::unordered_multimap<std::uint64_t, std::size_t>::iterator find_record(
+            std::uint64_t key_hash, const char *key, std::size_t key_length, unsigned char table);
+public:
+    explicit ResultStore(const std::string &filename);
+    ResultStore(const ResultStore &) = delete;
+    ResultStore &operator=(const ResultStore &) = delete;
+    ~ResultStore();
+    bool lookup(const std::string &graph6, unsigned char table, stored_graph &result);
+    void put(const std::string &graph6, const stored_graph &result);
+    std::size_t size() const { return index.size(); }
+};
+
+
+#endif //REFACTORED_THESIS_RESULTSTORE_H
@@ -0,0 +1,47 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "EvolutionaryAlgorithm.h"
+#include "LocalSearch.h"
+
+/**
+ * Compares the search engines on the evaluations (solve_mutation calls) they need to reach a target toughness: the
+ * (1+4) hill climber of EvolutionaryAlgorithm and the tabu search with annealing acceptance of LocalSearch. Both run
+ * from the same seeds with the same evaluation budget, and stop when the target is reached.
+ *
+ * Usage: search_bench [order] [runs] [target_toughness] [max_evaluations]
+ * Prints a CSV line per engine and run: the evaluations until the target was reached (-1 if it was not), the
+ * evaluations in total and until the final toughness, the final toughness and the seconds.
+ */
+int main(int argc, char **argv) {
+    int order = argc > 1 ? std::stoi(argv[1]) : 9;
+    int runs = argc > 2 ? std::stoi(argv[2]) : 10;
+    double target = argc > 3 ? std::stod(argv[3]) : 2.25;
+    long max_evaluations = argc > 4 ? std::stol(argv[4]) : 100000;
+    if (order <= 2 or runs <= 0 or target <= 0 or max_evaluations <= 4) {
+        std::cerr << "Usage: search_bench [order] [runs] [target_toughness] [max_evaluations]" << std::endl;
+        return 1;
+    }
+    search_options options;
+    options.target_toughness = target;
+    options.max_evaluations = max_evaluations;
+
+    std::cout << std::fixed << std::setprecision(5);
+    std::cout << "engine,seed,target_evaluation,evaluations,final_evaluation,toughness,seconds" << std::endl;
+    for (unsigned int seed = 0; seed < (unsigned int) runs; seed++) {
+        auto start = std::chrono::steady_clock::now();
+        // nextGen evaluates four mutations per iteration, after the initial graph
+        evolution_result evolved = EvolutionaryAlgorithm::evolve_graph(order, (max_evaluations - 1) / 4, seed, target);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "evolution," << seed << "," << (evolved.toughness >= target ? evolved.final_evaluation : -1)
+                  << "," << evolved.evaluations << "," << evolved.final_evaluation << "," << evolved.toughness << ","
+                  << seconds << std::endl;
+
+        search_result searched = LocalSearch::search(order, options, seed);
+        std::cout << "local_search," << seed << "," << searched.target_evaluation << "," << searched.evaluations
+                  << "," << searched.best_evaluation << "," << searched.best_toughness << "," << searched.seconds
+                  << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "SolveStats.h"
+
+#ifdef TNH_INSTRUMENT
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+const char *const stage_names[solve_stage_count] = {"current_sets", "prev_path", "prev_cut", "path_search",
+                                                    "full_scan"};
+
+/**
+ * The counters of the running threads, and the sum of those of the threads that have ended.
+ */
+struct registry_t {
+    std::mutex mutex;
+    std::vector<const solve_stats::thread_counters *> threads;
+    solve_stats::totals ended;
+};
+
+registry_t &registry() {
+    static registry_t instance;
+    return instance;
+}
+
+double rate(std::uint64_t part, std::uint64_t whole) {
+    return whole > 0 ? double(part) / whole : 0;
+}
+
+solve_stats::totals difference(const solve_stats::totals &now, const solve_stats::totals &start) {
+    solve_stats::totals result;
+    for (unsigned int e = 0; e < solve_event_count; e++) {
+        result.events[e] = now.events[e] - start.events[e];
+    }
+    for (unsigned int s = 0; s < solve_stage_count; s++) {
+        result.attempts[s] = now.attempts[s] - start.attempts[s];
+        result.hits[s] = now.hits[s] - start.hits[s];
+        result.cycles[s] = now.cycles[s] - start.cycles[s];
+    }
+    return result;
+}
+
+}
+
+namespace solve_stats {
+
+thread_counters::thread_counters() {
+    for (auto &counter : events) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (unsigned int s = 0; s < solve_stage_count; s++) {
+        attempts[s].store(0, std::memory_order_relaxed);
+        hits[s].store(0, std::memory_order_relaxed);
+        cycles[s].store(0, std::memory_order_relaxed);
+    }
+    registry_t &instance = registry();
+    std::lock_guard<std::mutex> lock(instance.mutex);
+    instance.threads.push_back(this);
+}
+
+thread_counters::~thread_counters() {
+    registry_t &instance = registry();
+    std::lock_guard<std::mutex> lock(instance.mutex);
+    add_to(instance.ended);
+    instance.threads.erase(std::find(instance.threads.begin(), instance.threads.end(), this));
+}
+
+void thread_counters::add_to(totals &sum) const {
+    for (unsigned int e = 0; e < solve_event_count; e++) {
+        sum.events[e] += events[e].load(std::memory_order_relaxed);
+    }
+    for (unsigned int s = 0; s < solve_stage_count; s++) {
+        sum.attempts[s] += attempts[s].load(std::memory_order_relaxed);
+        sum.hits[s] += hits[s].load(std::memory_order_relaxed);
+        sum.cycles[s] += cycles[s].load(std::memory_order_relaxed);
+    }
+}
+
+totals collect() {
+    registry_t &instance = registry();
+    std::lock_guard<std::mutex> lock(instance.mutex);
+    totals sum = instance.ended;
+    for (const thread_counters *counters : instance.threads) {
+        counters->add_to(sum);
+    }
+    return sum;
+}
+
+run::run() : start(collect()), start_time(std::chrono::steady_clock::now()), last_progress(start_time) {}
+
+/**
+ * Prints a progress line if progress_interval seconds have passed since the previous one. The clock is only read
+ * every 1024 calls, so this can be called once per graph.
+ */
+void run::progress() {
+    if (++calls % 1024 != 0) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<double>(now - last_progress).count() < progress_interval) {
+        return;
+    }
+    last_progress = now;
+    double seconds = std::chrono::duration<double>(now - start_time).count();
+    totals counts = difference(collect(), start);
+    std::ostringstream line;  // formatted apart, to leave the flags of std::cerr alone
+    line << std::fixed << std::setprecision(1) << "[solve] " << seconds << "s graphs "
+         << counts.events[event_graphs] << " (" << counts.events[event_graphs] / seconds << "/s) pairs "
+         << counts.events[event_pairs] << " (" << counts.events[event_pairs] / seconds << "/s) closure rejected "
+         << counts.events[event_closure_rejected] << " hits";
+    for (unsigned int s = 0; s < solve_stage_count; s++) {
+        line << " " << stage_names[s] << " " << 100 * rate(counts.hits[s], counts.attempts[s]) << "%";
+    }
+    std::cerr << line.str() << std::endl;
+}
+
+void run::summary(std::ostream &out) const {
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    totals counts = difference(collect(), start);
+    std::uint64_t total_cycles = 0;
+    for (auto stage_cycles : counts.cycles) {
+        total_cycles += stage_cycles;
+    }
+    std::ostringstream json;
+    json << "{\"seconds\": " << seconds
+         << ", \"graphs\": " << counts.events[event_graphs]
+         << ", \"graphs_per_s\": " << counts.events[event_graphs] / seconds
+         << ", \"pairs\": " << counts.events[event_pairs]
+         << ", \"pairs_per_s\": " << counts.events[event_pairs] / seconds
+         << ", \"counterexamples\": " << counts.events[event_counterexamples]
+         << ", \"closure_rejected\": " << counts.events[event_closure_rejected]
+         << ", \"stages\": {";
+    for (unsigned int s = 0; s < solve_stage_count; s++) {
+        json << (s > 0 ? ", " : "") << "\"" << stage_names[s] << "\": {\"attempts\": " << counts.attempts[s]
+             << ", \"hits\": " << counts.hits[s]
+             << ", \"hit_rate\": " << rate(counts.hits[s], counts.attempts[s])
+             << ", \"cycles\": " << counts.cycles[s]
+             << ", \"cycles_per_attempt\": " << rate(counts.cycles[s], counts.attempts[s])
+             << ", \"cycle_share\": " << rate(counts.cycles[s], total_cycles) << "}";
+    }
+    json << "}}";
+    out << json.str() << std::endl;
+}
+
+}
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef REFACTORED_THESIS_SOLVESTATS_H
+#define REFACTORED_THESIS_SOLVESTATS_H
+
+/**
+ * Instrumentation of EnumerationGraph::solve and the enumeration loops, enabled by defining TNH_INSTRUMENT (the CMake
+ * option of the same name). Without it every TNH_ macro below expands to nothing.
+ *
+ * solve resolves each vertex pair by the first stage that succeeds: a cut found earlier for this graph (current_sets),
+ * the Hamilton path or the cut of the same pair in the previous graph, the Hamilton path search, or the full scan
+ * over the subset tables. Per stage the attempts, the successes (hits) and the time stamp counter cycles spent are
+ * counted, as well as the graphs, pairs, counterexamples and the graphs the enumeration loops skip because of their
+ * closure. Every thread counts in its own counters, which are summed when a progress line or summary is printed.
+ *
+ * Usage: a TNH_RUN at the start of a run takes a snapshot of the counters, TNH_PROGRESS prints a progress line to
+ * std::cerr at most every progress_interval seconds, and TNH_SUMMARY writes the counts since the snapshot as JSON to
+ * std::cerr.
+ */
+#ifdef TNH_INSTRUMENT
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+enum solve_stage : unsigned int {
+    stage_current_sets,
+    stage_prev_path,
+    stage_prev_cut,
+    stage_path_search,
+    stage_full_scan,
+    solve_stage_count
+};
+
+enum solve_event : unsigned int {
+    event_graphs,            // graphs passed to solve
+    event_pairs,             // vertex pairs handled by solve
+    event_counterexamples,   // pairs without Hamilton path or cut
+    event_closure_rejected,  // graphs skipped by the enumeration loops because their closure is complete
+    solve_event_count
+};
+
+namespace solve_stats {
+
+struct totals {
+    std::array<std::uint64_t, solve_event_count> events{};
+    std::array<std::uint64_t, solve_stage_count> attempts{}, hits{}, cycles{};
+};
+
+/**
+ * The counters of one thread. Only the owning thread writes them, so an increment is a relaxed load and store, which
+ * other threads may read at any time while summing.
+ */
+struct thread_counters {
+    std::array<std::atomic<std::uint64_t>, solve_event_count> events;
+    std::array<std::atomic<std::uint64_t>, solve_stage_count> attempts, hits, cycles;
+
+    thread_counters();
+    ~thread_counters();
+    void add_to(totals &sum) const;
+};
+
+inline void bump(std::atomic<std::uint64_t> &counter, std::uint64_t amount = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+inline thread_counters &local() {
+    static thread_local thread_counters counters;
+    return counters;
+}
+
+inline std::uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * The sum of the counters of all threads, including threads that have ended.
+ */
+totals collect();
+
+/**
+ * Times the consecutive stages of a single pair: each stage is charged the cycles since the previous mark.
+ */
+class pair_timer {
+    std::uint64_t mark;
+public:
+    pair_timer() : mark(cycles()) {
+        bump(local().events[event_pairs]);
+    }
+    void end_stage(solve_stage stage, bool hit) {
+        std::uint64_t now = cycles();
+        thread_counters &counters = local();
+        bump(counters.attempts[stage]);
+        bump(counters.cycles[stage], now - mark);
+        if (hit) {
+            bump(counters.hits[stage]);
+        }
+        mark = now;
+    }
+};
+
+/**
+ * A run of the enumeration, reporting the counts since it was created.
+ */
+class run {
+    totals start;
+    std::chrono::steady_clock::time_point start_time, last_progress;
+    unsigned int calls = 0;
+public:
+    static constexpr double progress_interval = 10;  // seconds
+
+    run();
+    void progress();
+    void summary(std::ostream &out) const;
+};
+
+}
+
+#define TNH_COUNT(event) solve_stats::bump(solve_stats::local().events[event])
+#define TNH_PAIR_TIMER(timer) solve_stats::pair_timer timer
+#define TNH_STAGE_END(timer, stage, hit) timer.end_stage(stage, hit)
+#define TNH_RUN(name) solve_stats::run name
+#define TNH_PROGRESS(name) name.progress()
+#define TNH_SUMMARY(name) name.summary(std::cerr)
+
+#else
+
+#define TNH_COUNT(event)
+#define TNH_PAIR_TIMER(timer)
+#define TNH_STAGE_END(timer, stage, hit)
+#define TNH_RUN(name)
+#define TNH_PROGRESS(name)
+#define TNH_SUMMARY(name)
+
+#endif
+
+
+#endif //REFACTORED_THESIS_SOLVESTATS_H
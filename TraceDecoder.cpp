@@ -0,0 +1,26 @@
+#include <fstream>
+#include <iostream>
+#include "EvolutionTrace.h"
+
+/**
+ * Decodes a trace file of the evolutionary algorithm (see EvolutionTrace) to CSV.
+ *
+ * Usage: trace_decode trace_file [output.csv]
+ * The CSV is written to stdout by default.
+ */
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: trace_decode trace_file [output.csv]" << std::endl;
+        return 1;
+    }
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in) {
+        std::cerr << "The file doesn't exist" << std::endl;
+        return 1;
+    }
+    if (argc > 2) {
+        std::ofstream out(argv[2]);
+        return decode_trace(in, out) ? 0 : 1;
+    }
+    return decode_trace(in, std::cout) ? 0 : 1;
+}
@@ -0,0 +1,449 @@
+#include "WideKernels.h"
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace {
+
+constexpr unsigned int word_bits = 64;
+
+// std::bitset has no portable way to find its set bits, so they are read a 64 bit word at a time (libstdc++ has the
+// faster _Find_first and _Find_next, which the functions below use where available)
+std::uint64_t mask_word(const wide_mask_t &mask, std::size_t word) {
+    static const wide_mask_t low_word(~0ull);
+    return ((mask >> (word * word_bits)) & low_word).to_ullong();
+}
+
+/**
+ * Calls visit(v) for every vertex v of mask, in increasing order.
+ */
+template<class Visit>
+void for_each_vertex(const wide_mask_t &mask, Visit visit) {
+#ifdef __GLIBCXX__
+    for (std::size_t v = mask._Find_first(); v < max_wide_order; v = mask._Find_next(v)) {
+        visit(v);
+    }
+#else
+    for (std::size_t word = 0; word < max_wide_order / word_bits; word++) {
+        for (std::uint64_t bits = mask_word(mask, word); bits; bits &= bits - 1) {
+            visit(word * word_bits + (std::size_t) __builtin_ctzll(bits));
+        }
+    }
+#endif
+}
+
+using mask_words = std::array<std::uint64_t, max_wide_order / word_bits>;
+
+mask_words to_words(const wide_mask_t &mask) {
+    mask_words words{};
+    for (std::size_t word = 0; word < words.size(); word++) {
+        words[word] = mask_word(mask, word);
+    }
+    return words;
+}
+
+/**
+ * The lowest vertex of mask, or max_wide_order if it is empty.
+ */
+std::size_t first_vertex(const wide_mask_t &mask) {
+#ifdef __GLIBCXX__
+    return mask._Find_first();
+#else
+    for (std::size_t word = 0; word < max_wide_order / word_bits; word++) {
+        std::uint64_t bits = mask_word(mask, word);
+        if (bits != 0) {
+            return word * word_bits + (std::size_t) __builtin_ctzll(bits);
+        }
+    }
+    return max_wide_order;
+#endif
+}
+
+/**
+ * The vertices of within that are reached from start by paths inside within.
+ */
+wide_mask_t reached_from(const wide_mask_t *adjacency, unsigned int start, const wide_mask_t &within) {
+    wide_mask_t component, frontier;
+    component.set(start);
+    frontier = component;
+    while (frontier.any()) {
+        wide_mask_t reached;
+        for_each_vertex(frontier, [&](std::size_t v) {
+            reached |= adjacency[v];
+        });
+        frontier = reached & within & ~component;
+        component |= frontier;
+    }
+    return component;
+}
+
+/**
+ * Whether a path from last through all unvisited vertices can still end in to: every unvisited vertex needs two
+ * neighbours among the unvisited vertices and last (to needs one), and these vertices must be connected.
+ */
+bool can_complete(const wide_mask_t *adjacency, const wide_mask_t &unvisited, unsigned int last, unsigned int to) {
+    wide_mask_t remaining = unvisited;
+    remaining.set(last);
+    bool degrees = true;
+    for_each_vertex(unvisited, [&](std::size_t u) {
+        degrees = degrees and (adjacency[u] & remaining).count() >= (u == to ? 1u : 2u);
+    });
+    return degrees and reached_from(adjacency, last, remaining) == remaining;
+}
+
+}
+
+namespace wide {
+
+wide_mask_t full_mask(unsigned int order) {
+    wide_mask_t mask;
+    for (unsigned int i = 0; i < order; i++) {
+        mask.set(i);
+    }
+    return mask;
+}
+
+/**
+ * Number of components of the subgraph induced by alive that contain no vertex of pairs.
+ */
+int count_components(const wide_mask_t *adjacency, const wide_mask_t &alive, const wide_mask_t &pairs) {
+    int comp_count = 0;
+    wide_mask_t rest = alive;
+    while (rest.any()) {
+        wide_mask_t component = reached_from(adjacency, first_vertex(rest), rest);
+        rest &= ~component;
+        if ((component & pairs).none()) {
+            comp_count++;
+        }
+    }
+    return comp_count;
+}
+
+/**
+ * (2|S| + 1) / (2 omega') of the cut S = V \ alive, or no_cut_toughness if omega' = 0 or S is empty (which the subset
+ * tables of the smaller orders do not hold either).
+ */
+double toughness(const wide_mask_t *adjacency, unsigned int order, const wide_mask_t &alive,
+                 const wide_mask_t &pairs) {
+    if (alive.count() == order) {
+        return no_cut_toughness;
+    }
+    int comp_count = count_components(adjacency, alive, pairs);
+    if (comp_count > 0) {
+        double cut_size = order - (double) alive.count();
+        return (2 * cut_size + 1) / (2.0 * comp_count);
+    }
+    return no_cut_toughness;
+}
+
+/**
+ * Depth first search for a Hamilton path from -> to, which extends the path by the vertex with the fewest unvisited
+ * neighbours first and backtracks as soon as the unvisited vertices cannot complete the path (see can_complete).
+ * Gives up after hamilton_node_budget vertices have been tried, which says nothing about the path.
+ * @param path receives the Hamilton path if one is found
+ */
+hamilton_search hamilton_path(const wide_mask_t *adjacency, unsigned int order, unsigned int from, unsigned int to,
+                              std::vector<std::size_t> &path) {
+    if (from == to) {
+        return hamilton_none;
+    }
+    wide_mask_t to_bit, not_to;
+    to_bit.set(to);
+    not_to = ~to_bit;
+    wide_mask_t unvisited = full_mask(order);
+    unvisited.reset(from);
+    std::vector<unsigned int> stack(order);
+    std::vector<wide_mask_t> options(order);
+    unsigned int depth = 0;
+    stack[0] = from;
+    // the target may only be entered as the final vertex of the path
+    options[0] = adjacency[from] & unvisited & (order == 2 ? to_bit : not_to);
+    std::uint64_t nodes = 0;
+    while (true) {
+        if (options[depth].none()) {
+            if (depth == 0) {
+                return hamilton_none;
+            }
+            unvisited.set(stack[depth]);
+            depth--;
+            continue;
+        }
+        if (++nodes > hamilton_node_budget) {
+            return hamilton_budget_spent;
+        }
+        std::size_t v = max_wide_order;
+        std::size_t fewest = max_wide_order;
+        for_each_vertex(options[depth], [&](std::size_t u) {
+            std::size_t count = (adjacency[u] & unvisited).count();
+            if (count < fewest) {
+                v = u;
+                fewest = count;
+            }
+        });
+        options[depth].reset(v);
+        unvisited.reset(v);
+        if (depth + 2 == order) {
+            stack[++depth] = (unsigned int) v;
+            break;
+        }
+        if (not can_complete(adjacency, unvisited, (unsigned int) v, to)) {
+            unvisited.set(v);
+            continue;
+        }
+        stack[++depth] = (unsigned int) v;
+        options[depth] = adjacency[v] & unvisited & (depth + 2 == order ? to_bit : not_to);
+    }
+    path.assign(stack.begin(), stack.end());
+    return hamilton_found;
+}
+
+/**
+ * Whether the cut S = V \ alive proves that the graph has no Hamilton path at all: a Hamilton path meets at most
+ * |S| + 1 components of G - S.
+ */
+bool proves_nontraceable(const wide_mask_t *adjacency, unsigned int order, const wide_mask_t &alive) {
+    std::size_t cut_size = order - alive.count();
+    return (std::size_t) count_components(adjacency, alive, wide_mask_t()) > cut_size + 1;
+}
+
+/**
+ * Moves single vertices into or out of the cut while that lowers the toughness, for at most cut_search_passes passes.
+ */
+double improve_cut(const wide_mask_t *adjacency, unsigned int order, const wide_mask_t &pairs, wide_mask_t &alive) {
+    double tough = toughness(adjacency, order, alive, pairs);
+    for (unsigned int pass = 0; pass < cut_search_passes; pass++) {
+        bool improved = false;
+        for (unsigned int v = 0; v < order; v++) {
+            alive.flip(v);
+            double new_tough = toughness(adjacency, order, alive, pairs);
+            if (new_tough < tough) {
+                tough = new_tough;
+                improved = true;
+            } else {
+                alive.flip(v);
+            }
+        }
+        if (not improved) {
+            break;
+        }
+    }
+    return tough;
+}
+
+/**
+ * The cut of lowest toughness among all cuts S of one or two vertices, found exhaustively. For every vertex u, one
+ * depth first search of G - u yields the components of G - u - v for every v at once: as a depth first search leaves
+ * no edges between different subtrees, the subtree of a child c of v is a component of G - u - v iff its only
+ * neighbour outside the subtree is v (as for articulation points), and the rest of the component of v stays connected.
+ * @param best_alive receives the vertices not in the best cut, if one leaves a component without the pair
+ * @return its toughness, or no_cut_toughness
+ */
+double small_cut(const wide_mask_t *adjacency, unsigned int order, const wide_mask_t &pairs, wide_mask_t &best_alive) {
+    const wide_mask_t full = full_mask(order);
+    // the searches run on words, as reading the bits of a std::bitset one by one is slow
+    const std::size_t word_count = (order + word_bits - 1) / word_bits;
+    std::vector<mask_words> rows(order);
+    for (unsigned int v = 0; v < order; v++) {
+        rows[v] = to_words(adjacency[v]);
+    }
+    const mask_words full_words = to_words(full);
+    std::vector<int> parent(order), component(order);
+    // per vertex: its subtree, and the vertices of G - u adjacent to it
+    std::vector<mask_words> subtree(order), reach(order);
+    // per vertex v: the pair vertices in its subtree and in its separated child subtrees, and the number of separated
+    // child subtrees without a pair vertex
+    std::vector<int> subtree_pairs(order), separated_pairs(order), separated_free(order);
+    std::vector<int> component_pairs;  // the pair vertices per component of G - u
+    std::vector<unsigned int> stack;
+    double best = no_cut_toughness;
+    auto consider = [&](unsigned int u, unsigned int v, int comp_count) {
+        if (comp_count == 0) {
+            return;
+        }
+        double cut_size = u == v ? 1 : 2;
+        double tough = (2 * cut_size + 1) / (2.0 * comp_count);
+        if (tough < best) {
+            best = tough;
+            best_alive = full;
+            best_alive.reset(u);
+            best_alive.reset(v);
+        }
+    };
+    for (unsigned int u = 0; u < order; u++) {
+        mask_words unvisited = full_words;
+        unvisited[u / word_bits] &= ~(std::uint64_t(1) << u % word_bits);
+        // the lowest unvisited vertex in row, or order if there is none
+        auto first_unvisited = [&](const mask_words &row) {
+            for (std::size_t word = 0; word < word_count; word++) {
+                std::uint64_t bits = row[word] & unvisited[word];
+                if (bits != 0) {
+                    return (unsigned int) (word * word_bits + __builtin_ctzll(bits));
+                }
+            }
+            return order;
+        };
+        mask_words alive = unvisited;
+        component_pairs.clear();
+        auto visit = [&](unsigned int v, int from) {
+            unvisited[v / word_bits] &= ~(std::uint64_t(1) << v % word_bits);
+            subtree[v] = mask_words{};
+            subtree[v][v / word_bits] = std::uint64_t(1) << v % word_bits;
+            reach[v] = rows[v];
+            parent[v] = from;
+            component[v] = (int) component_pairs.size();
+            subtree_pairs[v] = pairs[v];
+            separated_pairs[v] = separated_free[v] = 0;
+            stack.push_back(v);
+        };
+        for (unsigned int root = first_unvisited(full_words); root < order; root = first_unvisited(full_words)) {
+            visit(root, -1);
+            while (not stack.empty()) {
+                unsigned int v = stack.back();
+                unsigned int next = first_unvisited(rows[v]);
+                if (next < order) {
+                    visit(next, (int) v);
+                    continue;
+                }
+                stack.pop_back();
+                int p = parent[v];
+                if (p >= 0) {
+                    // the subtree of v is finished, so it reaches outside only to ancestors
+                    bool separated = true;
+                    for (std::size_t word = 0; word < word_count; word++) {
+                        std::uint64_t outside = reach[v][word] & alive[word] & ~subtree[v][word];
+                        if (word == (unsigned int) p / word_bits) {
+                            outside &= ~(std::uint64_t(1) << p % word_bits);
+                        }
+                        separated = separated and outside == 0;
+                        reach[p][word] |= reach[v][word];
+                        subtree[p][word] |= subtree[v][word];
+                    }
+                    subtree_pairs[p] += subtree_pairs[v];
+                    if (separated) {
+                        separated_pairs[p] += subtree_pairs[v];
+                        separated_free[p] += subtree_pairs[v] == 0;
+                    }
+                }
+            }
+            component_pairs.push_back(subtree_pairs[root]);
+        }
+
+        int free_components = (int) std::count(component_pairs.begin(), component_pairs.end(), 0);
+        consider(u, u, free_components);
+        for (unsigned int v = u + 1; v < order; v++) {
+            int pairs_left = component_pairs[component[v]];
+            int comp_count = free_components - (pairs_left == 0) + separated_free[v];
+            // what remains of the component of v besides the separated subtrees, if v is not its root
+            if (parent[v] >= 0 and pairs_left - pairs[v] - separated_pairs[v] == 0) {
+                comp_count++;
+            }
+            consider(u, v, comp_count);
+        }
+    }
+    return best;
+}
+
+/**
+ * Local search for a cut of low toughness for the pair. Every cut of one or two vertices is evaluated (see small_cut),
+ * so these are never missed. The starting cuts are the best of these, start_alive (if not empty), the best prefix of
+ * the cut that greedily takes the vertex of highest degree among the remaining vertices, and the neighbourhoods of the
+ * cut_search_starts vertices of lowest degree (which isolate that vertex); each is improved by improve_cut. Stops as
+ * soon as a cut below tough_required is found.
+ * @param best_alive receives the vertices not in the best cut found
+ * @return the toughness of the best cut found, or no_cut_toughness
+ */
+double search_cut(const wide_mask_t *adjacency, unsigned int order, unsigned int pair1, unsigned int pair2,
+                  double tough_required, const wide_mask_t &start_alive, wide_mask_t &best_alive) {
+    wide_mask_t pairs;
+    pairs.set(pair1);
+    pairs.set(pair2);
+    const wide_mask_t full = full_mask(order);
+    std::vector<wide_mask_t> starts;
+    wide_mask_t small_alive;
+    double best = small_cut(adjacency, order, pairs, small_alive);
+    if (best < no_cut_toughness) {
+        best_alive = small_alive;
+        if (best < tough_required) {
+            return best;
+        }
+        starts.push_back(small_alive);
+    }
+    if (start_alive.any()) {
+        starts.push_back(start_alive);
+    }
+
+    wide_mask_t alive = full;
+    double greedy_tough = no_cut_toughness;
+    starts.push_back(full);
+    while (true) {
+        std::size_t v = max_wide_order;
+        std::size_t most = 0;
+        for_each_vertex(alive, [&](std::size_t u) {
+            std::size_t count = (adjacency[u] & alive).count();
+            if (v == max_wide_order or count > most) {
+                v = u;
+                most = count;
+            }
+        });
+        if (most == 0) {
+            break;
+        }
+        alive.reset(v);
+        double tough = toughness(adjacency, order, alive, pairs);
+        if (tough < greedy_tough) {
+            greedy_tough = tough;
+            starts.back() = alive;
+        }
+    }
+
+    std::vector<unsigned int> lowest;
+    for (unsigned int v = 0; v < order; v++) {
+        if (not pairs[v]) {
+            lowest.push_back(v);
+        }
+    }
+    auto by_degree = [&](unsigned int u, unsigned int v) {
+        return adjacency[u].count() < adjacency[v].count() or
+               (adjacency[u].count() == adjacency[v].count() and u < v);
+    };
+    std::size_t lowest_count = std::min<std::size_t>(cut_search_starts, lowest.size());
+    std::partial_sort(lowest.begin(), lowest.begin() + lowest_count, lowest.end(), by_degree);
+    for (std::size_t s = 0; s < lowest_count; s++) {
+        starts.push_back(full & ~adjacency[lowest[s]]);
+    }
+
+    for (auto &start : starts) {
+        double tough = improve_cut(adjacency, order, pairs, start);
+        if (tough < best) {
+            best = tough;
+            best_alive = start;
+        }
+        if (best < tough_required) {
+            break;
+        }
+    }
+    return best;
+}
+
+/**
+ * Converts a subset in the std::vector<bool> representation to a bitmask.
+ */
+wide_mask_t to_mask(const std::vector<bool> &subset) {
+    wide_mask_t mask;
+    for (std::size_t i = 0; i < subset.size(); i++) {
+        mask[i] = subset[i];
+    }
+    return mask;
+}
+
+/**
+ * Converts a bitmask back to the std::vector<bool> representation of a subset of {0, 1, ..., order-1}.
+ */
+void to_subset(const wide_mask_t &mask, unsigned int order, std::vector<bool> &subset) {
+    subset.resize(order);
+    for (unsigned int i = 0; i < order; i++) {
+        subset[i] = mask[i];
+    }
+}
+
+} // namespace wide
@@ -0,0 +1,55 @@
+#ifndef REFACTORED_THESIS_WIDEKERNELS_H
+#define REFACTORED_THESIS_WIDEKERNELS_H
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GraphKernels.h"
+
+// Orders above max_kernel_order up to max_wide_order keep a multi-word bitmask adjacency, see Graph::select_kernels
+constexpr unsigned int max_wide_order = 256;
+using wide_mask_t = std::bitset<max_wide_order>;
+
+/**
+ * The graph operations of the evolutionary algorithm for the orders without kernels, on a bitmask adjacency of
+ * max_wide_order bits per row.
+ * Beyond the kernel orders neither search is exhaustive: the Hamilton path search gives up after
+ * hamilton_node_budget nodes (and then reports that, see hamilton_search), and the cut search is a local search from
+ * a few starting cuts (see search_cut), whose toughness is an upper bound of that over all cuts. Only the cuts of one
+ * or two vertices are all evaluated.
+ */
+namespace wide {
+
+constexpr std::uint64_t hamilton_node_budget = 1 << 16;
+
+// The outcome of hamilton_path; only hamilton_none proves that there is no Hamilton path
+enum hamilton_search {
+    hamilton_found,
+    hamilton_none,
+    hamilton_budget_spent
+};
+// the vertices of lowest degree whose neighbourhood is one of the starting cuts of the cut search
+constexpr unsigned int cut_search_starts = 8;
+// the passes over all vertices per starting cut, see improve_cut
+constexpr unsigned int cut_search_passes = 4;
+
+wide_mask_t full_mask(unsigned int order);
+int count_components(const wide_mask_t *adjacency, const wide_mask_t &alive, const wide_mask_t &pairs);
+double toughness(const wide_mask_t *adjacency, unsigned int order, const wide_mask_t &alive,
+                 const wide_mask_t &pairs);
+hamilton_search hamilton_path(const wide_mask_t *adjacency, unsigned int order, unsigned int from, unsigned int to,
+                              std::vector<std::size_t> &path);
+bool proves_nontraceable(const wide_mask_t *adjacency, unsigned int order, const wide_mask_t &alive);
+double small_cut(const wide_mask_t *adjacency, unsigned int order, const wide_mask_t &pairs, wide_mask_t &best_alive);
+double improve_cut(const wide_mask_t *adjacency, unsigned int order, const wide_mask_t &pairs, wide_mask_t &alive);
+double search_cut(const wide_mask_t *adjacency, unsigned int order, unsigned int pair1, unsigned int pair2,
+                  double tough_required, const wide_mask_t &start_alive, wide_mask_t &best_alive);
+
+wide_mask_t to_mask(const std::vector<bool> &subset);
+void to_subset(const wide_mask_t &mask, unsigned int order, std::vector<bool> &subset);
+
+} // namespace wide
+
+
+#endif //REFACTORED_THESIS_WIDEKERNELS_H
@@ -0,0 +1,124 @@
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "WideKernels.h"
+
+/**
+ * Checks wide::search_cut against brute force on random graphs of order 5 to 32 with random pairs. The toughness of
+ * a cut is computed independently of WideKernels here (a breadth first search on adjacency lists). search_cut must
+ * report a cut with the toughness it returns, it must not miss a cut of one or two vertices (which small_cut
+ * evaluates exhaustively), and up to order 16 its toughness may not lie below that of the best of all cuts.
+ */
+
+namespace {
+
+const unsigned int max_test_order = 32;
+const unsigned int max_exhaustive_order = 16;
+const int graphs_per_order = 24;
+
+using adjacency_lists = std::vector<std::vector<unsigned int>>;
+
+// (2|S| + 1) / (2 omega') of the cut S = V \ alive, or no_cut_toughness if omega' = 0
+double brute_toughness(const adjacency_lists &graph, std::uint64_t alive, unsigned int pair1, unsigned int pair2) {
+    auto order = (unsigned int) graph.size();
+    std::uint64_t unseen = alive;
+    std::vector<unsigned int> queue;
+    int comp_count = 0;
+    unsigned int kept = 0;
+    for (unsigned int root = 0; root < order; root++) {
+        if (not (unseen >> root & 1)) {
+            continue;
+        }
+        bool has_pair = false;
+        unseen &= ~(std::uint64_t(1) << root);
+        queue.assign(1, root);
+        for (std::size_t i = 0; i < queue.size(); i++) {
+            unsigned int v = queue[i];
+            kept++;
+            has_pair = has_pair or v == pair1 or v == pair2;
+            for (unsigned int w : graph[v]) {
+                if (unseen >> w & 1) {
+                    unseen &= ~(std::uint64_t(1) << w);
+                    queue.push_back(w);
+                }
+            }
+        }
+        comp_count += not has_pair;
+    }
+    if (comp_count == 0) {
+        return no_cut_toughness;
+    }
+    return (2 * (order - (double) kept) + 1) / (2.0 * comp_count);
+}
+
+bool check_graph(const adjacency_lists &graph, const wide_mask_t *adjacency, unsigned int pair1, unsigned int pair2) {
+    auto order = (unsigned int) graph.size();
+    std::uint64_t full = (std::uint64_t(1) << order) - 1;
+    double best_small = no_cut_toughness;
+    for (unsigned int u = 0; u < order; u++) {
+        for (unsigned int v = u; v < order; v++) {
+            std::uint64_t alive = full & ~(std::uint64_t(1) << u) & ~(std::uint64_t(1) << v);
+            best_small = std::min(best_small, brute_toughness(graph, alive, pair1, pair2));
+        }
+    }
+    double best_all = 0;
+    if (order <= max_exhaustive_order) {
+        best_all = no_cut_toughness;
+        for (std::uint64_t alive = 0; alive < full; alive++) {
+            best_all = std::min(best_all, brute_toughness(graph, alive, pair1, pair2));
+        }
+    }
+
+    wide_mask_t best_alive;
+    double found = wide::search_cut(adjacency, order, pair1, pair2, 0, wide_mask_t(), best_alive);
+    std::uint64_t found_alive = 0;
+    for (unsigned int v = 0; v < order; v++) {
+        found_alive |= std::uint64_t(best_alive[v]) << v;
+    }
+    double reported = found < no_cut_toughness ? brute_toughness(graph, found_alive, pair1, pair2) : no_cut_toughness;
+    if (std::abs(reported - found) > 1e-9 or found > best_small + 1e-9 or found < best_all - 1e-9) {
+        std::cerr << "order " << order << ", pair " << pair1 << " " << pair2 << ": search_cut found " << found
+                  << " (its cut has " << reported << "), the cuts of one or two vertices " << best_small
+                  << ", all cuts " << best_all << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}
+
+int main() {
+    std::mt19937 rng(2021);
+    const double densities[] = {0.1, 0.2, 0.3, 0.5, 0.8};
+    int failures = 0;
+    int graphs = 0;
+    for (unsigned int order = 5; order <= max_test_order; order++) {
+        std::uniform_int_distribution<unsigned int> pick_vertex(0, order - 1);
+        for (int i = 0; i < graphs_per_order; i++) {
+            std::bernoulli_distribution coin_dist{densities[i % 5]};
+            adjacency_lists graph(order);
+            std::vector<wide_mask_t> adjacency(order);
+            for (unsigned int j = 1; j < order; j++) {
+                for (unsigned int k = 0; k < j; k++) {
+                    if (coin_dist(rng)) {
+                        graph[j].push_back(k);
+                        graph[k].push_back(j);
+                        adjacency[j].set(k);
+                        adjacency[k].set(j);
+                    }
+                }
+            }
+            unsigned int pair1 = pick_vertex(rng);
+            unsigned int pair2 = pick_vertex(rng);
+            while (pair2 == pair1) {
+                pair2 = pick_vertex(rng);
+            }
+            failures += not check_graph(graph, adjacency.data(), pair1, pair2);
+            graphs++;
+        }
+    }
+    std::cout << graphs << " graphs, " << failures << " failures" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
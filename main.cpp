@@ -13,6 +13,7 @@ void run_evolutionary_alg(int graph_size, int iterations) {
     std::cout << std::fixed;
     std::cout << std::setprecision(5);
     for (int i = 0; i < 10000; i++) {
+        // Pass a file name as third argument to append the trace of each run to it, see EvolutionTrace
         EvolutionaryAlgorithm survivor(graph_size, iterations);
     }
 }
@@ -21,10 +22,10 @@ void run_evolutionary_alg(int graph_size, int iterations) {
 int main(int argc, char** argv) {
     // Insert path to graph files as string below, or pass as argument.
     // Input data: http://users.cecs.anu.edu.au/~bdm/data/
-    std::string file_path = "/home/tim/CLionProjects/thesis/graphs/graph9c.g6";
     std::string file_path_chordal = "/home/tim/CLionProjects/thesis/graphs/chordal6.g6";
 
-    EnumerationAlgorithm::readFile(file_path);
+    // the connected graphs of order 9 (graph9c.g6) are generated in memory, use readFile to read them from a file
+    EnumerationAlgorithm::enumerateGraphs(9);
     EnumerationAlgorithm::readChordalFile(file_path_chordal);
 
     run_evolutionary_alg(8, 10000);
@@ -0,0 +1,96 @@
+#include "tnh.h"
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include "BatchSolver.h"
+#include "EvolutionaryAlgorithm.h"
+
+static_assert(sizeof(tnh_pair_result) == sizeof(pair_result) and
+              offsetof(tnh_pair_result, kind) == offsetof(pair_result, kind) and
+              offsetof(tnh_pair_result, path) == offsetof(pair_result, path) and
+              TNH_MAX_ORDER == max_kernel_order, "tnh_pair_result must have the layout of pair_result");
+
+struct tnh_solver {
+    BatchSolver solver;
+};
+
+namespace {
+
+thread_local std::string last_error;
+
+/**
+ * Runs body, turning an exception into the failure value and the message of tnh_last_error.
+ */
+template<class Result, class Body>
+Result guarded(Result failure, Body body) {
+    try {
+        return body();
+    } catch (const std::exception &error) {
+        last_error = error.what();
+    } catch (...) {
+        last_error = "unknown error";
+    }
+    return failure;
+}
+
+void copy_graph6(const std::string &graph6, char *target) {
+    if (graph6.size() >= TNH_MAX_GRAPH6_SIZE) {
+        throw std::length_error("The graph6 string does not fit the result");
+    }
+    std::memcpy(target, graph6.c_str(), graph6.size() + 1);
+}
+
+}
+
+tnh_solver *tnh_solver_create(unsigned int order, double toughness_test, int table) {
+    return guarded<tnh_solver *>(nullptr, [&] {
+        if (table != TNH_SET_SIZE_TABLE and table != TNH_ALL_SIZES_TABLE) {
+            throw std::invalid_argument("Unknown subset table");
+        }
+        return new tnh_solver{BatchSolver(order, toughness_test, (unsigned char) table)};
+    });
+}
+
+void tnh_solver_destroy(tnh_solver *solver) {
+    delete solver;
+}
+
+size_t tnh_pair_count(const tnh_solver *solver) {
+    return solver->solver.pair_count();
+}
+
+long tnh_solve_graph6(tnh_solver *solver, const char *buffer, size_t size, tnh_pair_result *results,
+                      size_t max_graphs) {
+    return guarded<long>(-1, [&] {
+        return (long) solver->solver.solve_lines(buffer, size, reinterpret_cast<pair_result *>(results), max_graphs);
+    });
+}
+
+int tnh_solve_adjacency(tnh_solver *solver, const uint32_t *adjacency, size_t count, tnh_pair_result *results) {
+    return guarded<int>(-1, [&] {
+        solver->solver.solve_tables(adjacency, count, reinterpret_cast<pair_result *>(results));
+        return 0;
+    });
+}
+
+int tnh_evolve(int order, int iterations, unsigned int seed, tnh_evolution_result *result) {
+    return guarded<int>(-1, [&] {
+        // above max_scanned_order the cuts are searched instead of scanned, see EvolutionGraph::solve_mutation_wide
+        if (order < 5 or order > int(max_wide_order)) {
+            throw std::invalid_argument("The order must lie in [5, " + std::to_string(max_wide_order) + "]");
+        }
+        evolution_result evolved = EvolutionaryAlgorithm::evolve_graph(order, iterations, seed);
+        result->initial_toughness = evolved.initial_toughness;
+        result->toughness = evolved.toughness;
+        result->final_iteration = evolved.final_iteration;
+        copy_graph6(evolved.initial_graph, result->initial_graph);
+        copy_graph6(evolved.graph, result->graph);
+        return 0;
+    });
+}
+
+const char *tnh_last_error(void) {
+    return last_error.c_str();
+}
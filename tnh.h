@@ -0,0 +1,100 @@
+#ifndef REFACTORED_THESIS_TNH_H
+#define REFACTORED_THESIS_TNH_H
+
+/**
+ * The C interface of the tnh library, for use from other languages (e.g. Python through ctypes or cffi).
+ * Inputs are read from and results are written to memory of the caller, nothing is copied in between: a buffer of
+ * graph6 lines (a geng file in memory) or of adjacency tables, and an array of tnh_pair_result for the results.
+ * Functions that can fail return NULL or -1, tnh_last_error then describes the error of the calling thread.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TNH_MAX_ORDER 24         /* the largest order of the batch solver */
+#define TNH_MAX_GRAPH6_SIZE 5448 /* a graph6 string of order at most 256, including the terminating null */
+
+enum tnh_pair_kind {
+    TNH_PAIR_PATH = 0,            /* a Hamilton path between the pair was found */
+    TNH_PAIR_CUT = 1,             /* a cut with (2|S| + 1) / (2 omega') < toughness_test was found */
+    TNH_PAIR_COUNTEREXAMPLE = 2,  /* neither, after scanning the complete subset table */
+    TNH_PAIR_CLOSURE = 3          /* the closure of the graph is complete, so the pair is traceable */
+};
+
+enum tnh_subset_table {
+    TNH_SET_SIZE_TABLE = 0,   /* the subset sizes of readFile, orders 5 to 12 */
+    TNH_ALL_SIZES_TABLE = 1   /* all subset sizes, as readChordalFile */
+};
+
+/**
+ * The result of one vertex pair (32 bytes), the pairs of a graph are in the order (0,1), (0,2), ..., (1,2), ...
+ */
+typedef struct tnh_pair_result {
+    uint32_t alive;               /* TNH_PAIR_CUT: the vertices not in the cut, as bitmask */
+    uint8_t kind;                 /* a tnh_pair_kind */
+    uint8_t components;           /* TNH_PAIR_CUT: omega', the components containing neither vertex of the pair */
+    uint8_t path[TNH_MAX_ORDER];  /* TNH_PAIR_PATH: the Hamilton path, from the first to the second vertex */
+    uint8_t reserved[2];
+} tnh_pair_result;
+
+typedef struct tnh_evolution_result {
+    double initial_toughness;
+    double toughness;
+    int final_iteration;  /* the iteration in which the final toughness was reached */
+    char initial_graph[TNH_MAX_GRAPH6_SIZE];
+    char graph[TNH_MAX_GRAPH6_SIZE];
+} tnh_evolution_result;
+
+typedef struct tnh_solver tnh_solver;
+
+/**
+ * Creates a solver for graphs of the given order (5 to TNH_MAX_ORDER), or returns NULL.
+ * table is a tnh_subset_table. A solver must only be used by one thread at a time.
+ */
+tnh_solver *tnh_solver_create(unsigned int order, double toughness_test, int table);
+void tnh_solver_destroy(tnh_solver *solver);
+
+/**
+ * The number of results per graph, order * (order - 1) / 2.
+ */
+size_t tnh_pair_count(const tnh_solver *solver);
+
+/**
+ * Solves the graph6 lines in buffer (size bytes, not null terminated, empty lines are skipped), at most max_graphs.
+ * results must hold max_graphs * tnh_pair_count(solver) entries.
+ * Returns the number of graphs solved, or -1 if a line is not a graph6 string of the order of the solver (the results
+ * of the graphs before it have been written).
+ */
+long tnh_solve_graph6(tnh_solver *solver, const char *buffer, size_t size, tnh_pair_result *results,
+                      size_t max_graphs);
+
+/**
+ * Solves count graphs given as consecutive adjacency tables, each of order rows (bit v of row i is set iff {i, v} is
+ * an edge). results must hold count * tnh_pair_count(solver) entries. Returns 0, or -1 if a table has a bit at or
+ * above the order, a loop or is not symmetric (the results of the graphs before it have been written).
+ */
+int tnh_solve_adjacency(tnh_solver *solver, const uint32_t *adjacency, size_t count, tnh_pair_result *results);
+
+/**
+ * Runs the evolutionary algorithm on a graph of the given order (5 to 256) for the given number of iterations, seeded
+ * by seed. Returns 0, or -1 on failure.
+ * Above order 12 the graphs are not verified: the toughness is an upper bound found by a heuristic cut search, and
+ * the Hamilton path search is limited (a search that gives up counts as a path, see README.md).
+ */
+int tnh_evolve(int order, int iterations, unsigned int seed, tnh_evolution_result *result);
+
+/**
+ * The error of the last failing call in this thread.
+ */
+const char *tnh_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //REFACTORED_THESIS_TNH_H